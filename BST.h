@@ -1,61 +1,128 @@
 #pragma once
 
+#include <atomic>
 #include <string>
-#include <sstream>
-#include <queue>
+#include "BSTBase.h"
+#include "LookupCache.h"
+
+/*
+ * Node objects which make up a BST
+ */
+template<typename KeyType>
+struct BSTNode {
+    KeyType key;
+    std::atomic<int> refs; // Number of links to this node
+    BSTNode *left, *right; // Left and right child
+
+    /**
+     * Node constructor.
+     *
+     * @param key   Key of the node
+     * @param left  Left child
+     * @param right Right child
+     */
+    BSTNode(const KeyType &key, BSTNode *left = nullptr,
+            BSTNode *right = nullptr) {
+        this->key = key;
+        this->refs = 1;
+        this->left = left;
+        this->right = right;
+    }
+
+    /**
+     * Node copy constructor - copies the key and links to the same children.
+     * The copy starts with a single link to it.
+     *
+     * @param other Node to copy
+     */
+    BSTNode(const BSTNode &other)
+            : key(other.key), refs(1), left(other.left), right(other.right) {}
+
+    /**
+    * Find the maximum node's value.
+    *
+    * @return Key of the right-most node in this subtree
+    */
+    const KeyType &findMax() const {
+        if (right == nullptr) {
+            return this->key;
+        } else {
+            return right->findMax();
+        }
+    }
+};
 
 /**
  * Binary Search Tree template class. Methods are defined for adding and
  * removing from the tree, checking if the tree is empty, has a
  * given key, number of leaf nodes, height, and width of the tree. Post order,
- * in order, pre order, and level order traversal methods are also defined.
+ * in order, pre order, and level order traversal methods are also defined
+ * (in BSTBase, which BST shares with BSTMap).
+ * An optional lookup cache can be enabled in front of has for hot keys, by
+ * instantiating the tree with LookupCache<KeyType> as CacheType. The default,
+ * NoLookupCache, compiles the cache away, so a plain BST<KeyType> only needs
+ * KeyType to be comparable with < and >.
+ * Copying a tree is O(1): the copy shares nodes with the original, and each
+ * tree copies only the shared nodes on the path of an add or remove which
+ * changes it (adding a present key or removing an absent one copies
+ * nothing).
  *
- * @tparam  KeyType Data type of the key
+ * @tparam  KeyType   Data type of the key
+ * @tparam  CacheType Lookup cache in front of has
  * @author  Francis Kogge
  * @version 1.0
  * @date    12/09/2020
  */
-template<typename KeyType>
-class BST {
+template<typename KeyType, typename CacheType = NoLookupCache<KeyType> >
+class BST : public BSTBase<KeyType, BSTNode<KeyType> > {
+    typedef BSTBase<KeyType, BSTNode<KeyType> > Base;
+    typedef typename Base::Node Node;
+    using Base::root;
+    using Base::path;
+    using Base::create;
+    using Base::destroy;
 
 public:
     /**
      * Constructor - initializes root.
      */
-    BST() : root(nullptr) {};
+    BST() {};
 
     /**
-     * Copy constructor - creates copy of the tree.
+     * Copy constructor - creates copy of the tree which shares its nodes
+     * with the other tree until either of them changes.
      *
      * @param other BST object to copy
      */
-    BST(const BST<KeyType> &other) {
-        root = copy(other.root);
-    }
+    BST(const BST<KeyType, CacheType> &other)
+            : Base(other), cache(other.cache) {}
 
     /**
-     * Overloaded assignment operator - destroys current tree and creates
-     * copy of the tree.
+     * Converting constructor - creates copy of a tree with a different kind
+     * of lookup cache, sharing its nodes like the copy constructor. The
+     * copy's cache starts out disabled.
+     *
+     * @param other BST object to copy
+     */
+    template<typename OtherCacheType>
+    explicit BST(const BST<KeyType, OtherCacheType> &other) : Base(other) {}
+
+    /**
+     * Overloaded assignment operator - releases current tree and shares the
+     * nodes of the other tree.
      *
      * @param rhs BST object to copy (on right hand side of operator).
      * @return    This BST
      */
-    BST<KeyType> &operator=(const BST<KeyType> &rhs) {
+    BST<KeyType, CacheType> &operator=(const BST<KeyType, CacheType> &rhs) {
         // If assignment is not to this instance
         if (this != &rhs) {
-            clear(root);
-            root = copy(rhs.root);
+            Base::operator=(rhs);
+            cache.invalidate();
         }
         return *this;
     }
 
-    /**
-     * Destructor - calls helper method, clear.
-     */
-    ~BST() {
-        clear(root);
-    }
-
     /**
      * Insert a new element into the tree. If the element is already in the
      * tree, this method does nothing.
@@ -63,7 +130,12 @@ public:
      * @param newKey Key to insert
      */
     void add(const KeyType &newKey) {
-        root = add(root, newKey);
+        Base::reclaimSome();
+        path.clear();
+        if (!Base::findPath(newKey, path)) {
+            *Base::ownPath(newKey, path) = create(newKey);
+        }
+        cache.update(newKey, true);
     }
 
     /**
@@ -74,7 +146,14 @@ public:
      *            False if it is not present
      */
     bool has(const KeyType &key) const {
-        return has(root, key);
+        bool present;
+        // Answer from the cache if it has seen this key before
+        if (cache.lookup(key, present)) {
+            return present;
+        }
+        present = has(root, key);
+        cache.store(key, present);
+        return present;
     }
 
     /**
@@ -83,201 +162,65 @@ public:
      * @param key Key to remove
      */
     void remove(const KeyType &key) {
-        root = remove(root, key);
-    }
-
-    /**
-     * Check if this tree is empty.
-     *
-     * @return True if empty
-     *         False if not empty
-     */
-    bool empty() const {
-       return root == nullptr;
-    }
-
-    /**
-     * Returns the size the tree.
-     *
-     * @return Size of the tree
-     */
-    int size() const {
-        return size(root);
-    }
-
-    /**
-     * Returns the number of leaf nodes (node with no child nodes) in the tree.
-     *
-     * @return Number of leaf nodes in the tree
-     */
-    int getLeafCount() const {
-        return getLeafCount(root);
-    }
-
-    /**
-     * Returns the height of the tree.
-     *
-     * @return Height of the tree
-     */
-    int getHeight() const {
-        return getHeight(root);
+        Base::reclaimSome();
+        path.clear();
+        if (Base::findPath(key, path)) {
+            destroy(Base::unlink(Base::ownPath(key, path)));
+        }
+        cache.update(key, false);
     }
 
     /**
-     * Returns the width of the tree (the largest number of nodes in the same
-     * level).
-     *
-     * @return Width of the tree
+     * Removes every key from the tree. With deferred destruction on, this
+     * only detaches the root and the nodes are deleted later.
      */
-    int getWidth() const {
-        int height = getHeight(root), maxWidth = 0;
-        // Iterate through each level of the tree
-        for (int level = 0; level < height; level++) {
-            // Get the current level width
-            maxWidth = std::max(getLevelWidth(root, level), maxWidth);
-        }
-        return maxWidth;
+    void clear() {
+        Base::clear();
+        cache.invalidate();
     }
 
     /**
-     * Returns a string representing the in-order traversal.
+     * Enables the lookup cache in front of has, discarding any cached keys.
+     * Only available when CacheType is LookupCache. While the cache is on,
+     * has records its results in the cache, so a const tree is no longer
+     * safe to search from several threads at once.
      *
-     * @return Key of each node, in-order
+     * @param slots Number of cache slots (rounded up to a power of two)
      */
-    std::string getInOrderTraversal() const {
-        std::ostringstream ss;
-        getInOrderTraversal(root, ss);
-        return ss.str();
+    void enableCache(std::size_t slots = DEFAULT_CACHE_SLOTS) {
+        cache.resize(slots);
     }
 
     /**
-     * Returns a string representing the pre-order traversal.
-     *
-     * @return Key of each node, pre-order
+     * Disables the lookup cache and frees its slots.
      */
-    std::string getPreOrderTraversal() const {
-        std::ostringstream ss;
-        getPreOrderTraversal(root, ss);
-        return ss.str();
+    void disableCache() {
+        cache.resize(0);
     }
 
     /**
-     * Returns a string representing the post-order traversal.
+     * Returns the number of calls to has answered by the lookup cache.
      *
-     * @return Key of each node, post-order
+     * @return Number of cache hits
      */
-    std::string getPostOrderTraversal() const {
-        std::ostringstream ss;
-        getPostOrderTraversal(root, ss);
-        return ss.str();
+    long getCacheHits() const {
+        return cache.getHits();
     }
 
     /**
-     * Returns a string representing the level-order traversal.
+     * Returns the number of calls to has which had to search the tree while
+     * the lookup cache was enabled.
      *
-     * @return Key of each node, level-order
+     * @return Number of cache misses
      */
-    std::string getLevelOrderTraversal() const {
-        // In case client calls on an empty tree
-        if (empty()) {
-            return "";
-        } else {
-            std::ostringstream ss;
-            // Queue of Node pointers to keep track of order to print
-            std::queue<Node*> nodes;
-            Node *current;
-            nodes.push(root);
-
-            while (!nodes.empty()){
-                // Get the node at the front of queue and print it out
-                current = nodes.front();
-                ss << current->key << " ";
-                if (current->left != nullptr) {
-                    // Enqueue left child first in order to print the tree
-                    // from left to right
-                    nodes.push(current->left);
-                }
-                if (current->right != nullptr) {
-                    // Enqueue right child
-                    nodes.push(current->right);
-                }
-                // Remove front element so next node in queue can be printed
-                nodes.pop();
-            }
-            return ss.str();
-        }
+    long getCacheMisses() const {
+        return cache.getMisses();
     }
 
 private:
-    /*
-     * Node objects which make up the binary search tree
-     */
-    struct Node {
-        KeyType key;
-        Node *left, *right; // Left and right child
+    static const std::size_t DEFAULT_CACHE_SLOTS = 1024;
 
-        /**
-         * Node constructor.
-         *
-         * @param key   Key of the node
-         * @param left  Left child
-         * @param right Right child
-         */
-        Node(const KeyType &key, Node *left = nullptr, Node *right = nullptr) {
-            this->key = key;
-            this->left = left;
-            this->right = right;
-        }
-
-        /**
-        * Find the maximum node's value.
-        *
-        * @return Key of the right-most node in this subtree
-        */
-        const KeyType &findMax() const {
-            if (right == nullptr) {
-                return this->key;
-            } else {
-                return right->findMax();
-            }
-        }
-
-        /**
-         * Checks if this node is a leaf.
-         *
-         * @return True if it is a leaf
-         *         False if it is not a leaf
-         */
-        bool isLeaf() const {
-            // Leaf node must have no left child and no right child
-            return this->left == nullptr && this->right == nullptr;
-        }
-    };
-
-    Node *root; // Root of the tree
-
-    /**
-    * Recursive helper method for add.
-     *
-    * @param current Subtree to which to add key
-    * @param newKey  Key to add
-    * @return        Current node
-    */
-    static Node *add(Node *current, const KeyType &newKey) {
-        if (current == nullptr) {
-            // Add node if we found a spot in the tree that is null
-            current = new Node(newKey);
-        }
-
-        if (newKey < current->key) {
-            // Find a spot to the left of the current node
-            current->left = add(current->left, newKey);
-        } else if (newKey > current->key) {
-            // Find a spot to the right of the current node
-            current->right = add(current->right, newKey);
-        }
-        return current;
-    }
+    mutable CacheType cache; // Cache in front of has
 
     /**
     * Recursive helper method for has.
@@ -304,215 +247,4 @@ private:
             return true;
         }
     }
-
-    /**
-     * Recursive helper method for remove.
-     *
-     * @param current Subtree from which to remove key
-     * @param key     Key to remove
-     * @return        Current node or replacement node (if current is deleted)
-     */
-    static Node *remove(Node *current, const KeyType &key) {
-        // If we recursed down the tree and reached null, key is not in the tree
-        if (current == nullptr) {
-            return nullptr;
-        }
-
-        if (key < current->key) {
-            // Check the left subtree
-            current->left = remove(current->left, key);
-            return current;
-        } else if (key > current->key) {
-            // Check the right subtree
-            current->right = remove(current->right, key);
-            return current;
-        // If current node has the key, we found the node to remove
-        } else {
-            if (current->left == nullptr) {
-                // Replace the current node with its right child
-                Node *replacement = current->right;
-                delete current;
-                return replacement;
-            } else if (current->right == nullptr) {
-                // Replace the current node with its left child
-                Node *replacement = current->left;
-                delete current;
-                return replacement;
-            } else {
-                // Find max value node from the left subtree, and replace the
-                // current node's key with that value
-                current->key = current->left->findMax();
-                // Current node has been replaced, so now we can remove the node
-                // that had the replacement key
-                current->left = remove(current->left, current->key);
-                return current;
-            }
-        }
-    }
-
-    /**
-     * Recursive helper method for size.
-     *
-     * @param current Subtree to find size of
-     * @return        Number of nodes in the tree
-     */
-    static int size(Node *current) {
-        // Once a null node is reached, stop traversing sub-tree
-        if (current == nullptr) {
-            // Adds 0 to recursive sum, indicating the current sub-tree is empty
-            return 0;
-        }
-
-        // Return size of left and right sub-trees, plus 1 to represent
-        // current node
-        return size(current->left) + 1 + size(current->right);
-    }
-
-    /**
-     * Recursive helper method for getLeafCount.
-     *
-     * @param current Subtree in which to find number of leaves
-     * @return        Number of leaf nodes
-     */
-    static int getLeafCount(Node *current) {
-        // Once null node is reached, stop traversing sub-tree
-        if (current == nullptr) {
-            // Adds 0 to recursive sum -> empty sub-tree implies no leaves
-            return 0;
-        }
-
-        if (current->isLeaf()) {
-            // 1 is added to recursive sum, meaning a leaf was found
-            return 1;
-        } else {
-            // Get the leaf count of the left sub-tree and the right sub-tree
-            return getLeafCount(current->left) + getLeafCount(current->right);
-        }
-    }
-
-    /**
-     * Recursive helper method for getHeight.
-     *
-     * @param current Subtree to find height of
-     * @return        Height of the tree
-     */
-    static int getHeight(Node *current) {
-        // If null node is reached, don't add anything to the recursive sum
-        if (current == nullptr) {
-            return 0;
-        } else {
-            // Return 1 (to represent current node being visited) plus the
-            // height of the subtree which has the greater height
-            return 1 + std::max(getHeight(current->left),
-                                getHeight(current->right));
-        }
-    }
-
-    /**
-     * Recursive helper method for getWidth that returns the width of an
-     * individual level of the tree.
-     *
-     * @param current       Current node being visited
-     * @param remainingLvls Initially represents the level to get the width of.
-     *                      While recursing down the tree, it represents how
-     *                      many levels are left to go down until we reach
-     *                      the level we would like to obtain the width of.
-     * @return              Width of the level
-     */
-    static int getLevelWidth(Node *current, int remainingLvls) {
-        // Don't add anything to recursive sum if null node is reached
-        if (current == nullptr) {
-            return 0;
-        }
-        // If there are no more levels left to go down (or case where root is
-        // the only node)
-        if (remainingLvls == 0) {
-            // Adds 1 to recursive sum to represent the current visited node
-            return 1;
-        } else {
-            // Start at root and walk down the tree with each recursive call
-            // until no more levels are left to go down (remainingLvls == 0)
-            return getLevelWidth(current->left, remainingLvls - 1) +
-                   getLevelWidth(current->right, remainingLvls - 1);
-        }
-    }
-
-    /**
-     * Recursive helper method for getInOrderTraversal.
-     *
-     * @param current Subtree to traverse, in-order
-     * @param ss      Output string stream
-     */
-    static void getInOrderTraversal(Node *current, std::ostringstream &ss) {
-        if (current == nullptr)  {
-            return;
-        }
-
-        // Print left, current, then right node to string stream
-        getInOrderTraversal(current->left, ss);
-        ss << current->key << " ";
-        getInOrderTraversal(current->right, ss);
-    }
-
-    /**
-     * Recursive helper method for getPreOrderTraversal.
-     *
-     * @param current Subtree to traverse, pre-order
-     * @param ss      Output string stream
-     */
-    static void getPreOrderTraversal(Node *current, std::ostringstream &ss) {
-        if (current == nullptr)  {
-            return;
-        }
-
-        // Print current, left, then right node to string stream
-        ss << current->key << " ";
-        getPreOrderTraversal(current->left, ss);
-        getPreOrderTraversal(current->right, ss);
-    }
-
-    /**
-     * Recursive helper method for getPostOrderTraversal.
-     *
-     * @param current Subtree to traverse, post-order
-     * @param ss      Output string stream
-     */
-    static void getPostOrderTraversal(Node *current, std::ostringstream &ss) {
-        if (current == nullptr)  {
-            return;
-        }
-
-        // Print left, right, then current node to string stream
-        getPostOrderTraversal(current->left, ss);
-        getPostOrderTraversal(current->right, ss);
-        ss << current->key << " ";
-    }
-
-    /**
-     * Recursive helper method to copy a subtree.
-     *
-     * @param current Root of the subtree to copy
-     * @return        Copy of the subtree
-     */
-    static Node *copy(Node *current) {
-        if (current == nullptr) {
-            return nullptr;
-        } else {
-            return new Node(current->key, copy(current->left),
-                            copy(current->right));
-        }
-    }
-
-    /**
-     * Recursive helper method to delete a subtree.
-     *
-     * @param current Root of the subtree to delete
-     */
-    void clear(Node *current) {
-        if (current != nullptr) {
-            clear(current->left);
-            clear(current->right);
-            delete current;
-        }
-    }
 };
\ No newline at end of file
@@ -0,0 +1,976 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <sstream>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "Generator.h"
+#include "Reclaimer.h"
+
+/**
+ * Base class template shared by BST, BSTMap and BSTMultiset. It owns the
+ * root of the tree and defines everything that does not depend on what a node
+ * holds besides its key: allocating, sharing and deleting nodes, searching,
+ * unlinking a node, and the size, shape and traversal methods, including a
+ * resumable in-order Cursor for exporting a large tree a chunk at a time.
+ *
+ * Deleting a large tree can stall the caller, so a tree can defer it: with
+ * deferred destruction on, clear and assignment detach the old root in O(1)
+ * and the detached nodes are deleted a few at a time by later writes to the
+ * tree, or by calling reclaim. Destroying a tree (or a Cursor over it) with
+ * deferred destruction on hands its nodes to the background Reclaimer
+ * thread instead, which is safe because link counts are atomic.
+ *
+ * Copies share structure. Each node counts the links (from parent nodes or
+ * tree roots) pointing to it, copying a tree just links the copy to the same
+ * root, and a node is only deleted once nothing links to it. Before a tree
+ * changes a node it calls own, which copies the node if it is shared, so a
+ * write copies the shared nodes on its path and nothing else. Derived
+ * classes must go through findLink, ownPath, own or unlink before changing a
+ * node, and writes which may turn out to change nothing search with findPath
+ * first, so that they don't copy anything unless they do change the tree.
+ * Link counts are atomic, so copies of a tree can be handed to other threads
+ * and changed or destroyed there independently of the original (a single
+ * tree object still must not be used from several threads while it is being
+ * changed).
+ *
+ * NodeType must have a public key member of type KeyType, a std::atomic<int>
+ * refs member which the constructors set to 1, left and right child pointers
+ * of type NodeType*, and a copy constructor which copies everything else.
+ *
+ * @tparam  KeyType  Data type of the key
+ * @tparam  NodeType Data type of the nodes
+ * @author  Francis Kogge
+ * @version 1.0
+ * @date    12/09/2020
+ */
+template<typename KeyType, typename NodeType>
+class BSTBase {
+
+public:
+    /**
+     * Check if this tree is empty.
+     *
+     * @return True if empty
+     *         False if not empty
+     */
+    bool empty() const {
+       return root == nullptr;
+    }
+
+    /**
+     * Returns the size the tree.
+     *
+     * @return Size of the tree
+     */
+    int size() const {
+        return size(root);
+    }
+
+    /**
+     * Returns the number of leaf nodes (node with no child nodes) in the tree.
+     *
+     * @return Number of leaf nodes in the tree
+     */
+    int getLeafCount() const {
+        return getLeafCount(root);
+    }
+
+    /**
+     * Returns the height of the tree.
+     *
+     * @return Height of the tree
+     */
+    int getHeight() const {
+        return getHeight(root);
+    }
+
+    /**
+     * Returns the width of the tree (the largest number of nodes in the same
+     * level).
+     *
+     * @return Width of the tree
+     */
+    int getWidth() const {
+        int height = getHeight(root), maxWidth = 0;
+        // Iterate through each level of the tree
+        for (int level = 0; level < height; level++) {
+            // Get the current level width
+            maxWidth = std::max(getLevelWidth(root, level), maxWidth);
+        }
+        return maxWidth;
+    }
+
+    /**
+     * Returns a string representing the in-order traversal.
+     *
+     * @return Key of each node, in-order
+     */
+    std::string getInOrderTraversal() const {
+        std::ostringstream ss;
+        getInOrderTraversal(root, ss);
+        return ss.str();
+    }
+
+    /**
+     * Returns a string representing the pre-order traversal.
+     *
+     * @return Key of each node, pre-order
+     */
+    std::string getPreOrderTraversal() const {
+        std::ostringstream ss;
+        getPreOrderTraversal(root, ss);
+        return ss.str();
+    }
+
+    /**
+     * Returns a string representing the post-order traversal.
+     *
+     * @return Key of each node, post-order
+     */
+    std::string getPostOrderTraversal() const {
+        std::ostringstream ss;
+        getPostOrderTraversal(root, ss);
+        return ss.str();
+    }
+
+    /**
+     * Returns a string representing the level-order traversal.
+     *
+     * @return Key of each node, level-order
+     */
+    std::string getLevelOrderTraversal() const {
+        // In case client calls on an empty tree
+        if (empty()) {
+            return "";
+        } else {
+            std::ostringstream ss;
+            // Queue of Node pointers to keep track of order to print
+            std::queue<Node*> nodes;
+            Node *current;
+            nodes.push(root);
+
+            while (!nodes.empty()){
+                // Get the node at the front of queue and print it out
+                current = nodes.front();
+                ss << current->key << " ";
+                if (current->left != nullptr) {
+                    // Enqueue left child first in order to print the tree
+                    // from left to right
+                    nodes.push(current->left);
+                }
+                if (current->right != nullptr) {
+                    // Enqueue right child
+                    nodes.push(current->right);
+                }
+                // Remove front element so next node in queue can be printed
+                nodes.pop();
+            }
+            return ss.str();
+        }
+    }
+
+    /**
+     * Removes every key from the tree. With deferred destruction on, this
+     * only detaches the root and the nodes are deleted later.
+     */
+    void clear() {
+        release(root);
+        root = nullptr;
+    }
+
+    /**
+     * Turns deferred destruction on or off. While it is on, each add,
+     * remove or other write first deletes up to the given number of
+     * detached nodes. Turning it off leaves already detached nodes for
+     * reclaim (or the destructor). While it is on, the destructor and
+     * Cursor's destructor don't delete any nodes themselves, they hand them
+     * to the background Reclaimer.
+     *
+     * @param nodesPerWrite Nodes to delete per write, 0 to delete trees
+     *                      immediately (the default)
+     */
+    void setDeferredDestruction(std::size_t nodesPerWrite) {
+        reclaimPerWrite = nodesPerWrite;
+    }
+
+    /**
+     * Deletes detached nodes, up to the given budget.
+     *
+     * @param budget Largest number of nodes to visit (nodes which are still
+     *               shared with another tree are visited but not deleted)
+     * @return       Number of nodes deleted
+     */
+    std::size_t reclaim(std::size_t budget) {
+        return reclaim(detached, budget);
+    }
+
+    /**
+     * Check if there are detached nodes waiting to be deleted.
+     *
+     * @return True if reclaim has work left
+     *         False if not
+     */
+    bool hasPendingReclaim() const {
+        return !detached.empty();
+    }
+
+protected:
+    typedef NodeType Node;
+
+    /*
+     * Stack of nodes for an in-order traversal, which needs no parent links.
+     * The node on top is the current one, and under it are the ancestors
+     * whose key and right subtree come after it (the nodes whose left subtree
+     * holds the current node). Stepping to the next node takes O(1) time on
+     * average, and the stack never holds more nodes than the height of the
+     * tree. Shared by Cursor and BSTMap's iterators.
+     */
+    class InOrderStack {
+    public:
+        /**
+         * Check if the traversal is finished.
+         *
+         * @return True if there is no current node
+         *         False if there is
+         */
+        bool empty() const {
+            return nodes.empty();
+        }
+
+        /**
+         * Returns the current node.
+         *
+         * @return Current node, or nullptr once finished
+         */
+        Node *top() const {
+            return nodes.empty() ? nullptr : nodes.back();
+        }
+
+        /**
+         * Empties the stack, finishing the traversal.
+         */
+        void clear() {
+            nodes.clear();
+        }
+
+        /**
+         * Pushes a node and its chain of left children, moving to the
+         * smallest key in the node's subtree.
+         *
+         * @param current Root of the subtree to visit next (may be nullptr)
+         */
+        void pushLeftPath(Node *current) {
+            while (current != nullptr) {
+                nodes.push_back(current);
+                current = current->left;
+            }
+        }
+
+        /**
+         * Steps to the next node in order.
+         */
+        void next() {
+            Node *current = nodes.back();
+            nodes.pop_back();
+            pushLeftPath(current->right);
+        }
+
+        /**
+         * Moves to the node holding a key.
+         *
+         * @param root Root of the tree
+         * @param key  Key to search for
+         * @return     True if found
+         *             False if not found, which finishes the traversal
+         */
+        bool find(Node *root, const KeyType &key) {
+            nodes.clear();
+            Node *current = root;
+            while (current != nullptr) {
+                if (key < current->key) {
+                    // Current node comes after the key
+                    nodes.push_back(current);
+                    current = current->left;
+                } else if (key > current->key) {
+                    current = current->right;
+                } else {
+                    nodes.push_back(current);
+                    return true;
+                }
+            }
+            nodes.clear();
+            return false;
+        }
+
+        /**
+         * Moves to the last node of a path, without comparing any keys.
+         *
+         * @param path Nodes from the root down to the node to move to
+         */
+        void assign(const std::vector<Node*> &path) {
+            nodes.clear();
+            nodes.reserve(path.size());
+            for (std::size_t i = 0; i + 1 < path.size(); i++) {
+                if (path[i]->left == path[i + 1]) {
+                    nodes.push_back(path[i]);
+                }
+            }
+            nodes.push_back(path.back());
+        }
+
+    private:
+        std::vector<Node*> nodes; // Current node and the ancestors after it
+    };
+
+public:
+    /*
+     * Resumable in-order traversal, which hands out keys a chunk at a time
+     * so that exporting a large tree can be interleaved with other work. A
+     * cursor holds a link to the root of the tree as it was when the cursor
+     * was created, so it keeps seeing that snapshot (and keeps its nodes
+     * alive) even if the tree is changed or destroyed in the meantime. Memory
+     * used by a cursor is proportional to the height of the tree.
+     */
+    class Cursor {
+    public:
+        /**
+         * Constructor - creates a cursor positioned before the smallest key of
+         * a tree.
+         *
+         * @param tree Tree to traverse
+         */
+        explicit Cursor(const BSTBase<KeyType, NodeType> &tree)
+                : snapshot(tree.root), deferred(tree.reclaimPerWrite > 0) {
+            retain(snapshot);
+            stack.pushLeftPath(snapshot);
+        }
+
+        /**
+         * Move constructor - takes over the other cursor's position.
+         *
+         * @param other Cursor to move from
+         */
+        Cursor(Cursor &&other)
+                : snapshot(other.snapshot), deferred(other.deferred),
+                  stack(std::move(other.stack)) {
+            other.snapshot = nullptr;
+            other.stack.clear();
+        }
+
+        Cursor(const Cursor &other) = delete;
+        Cursor &operator=(const Cursor &rhs) = delete;
+
+        /**
+         * Destructor - releases the snapshot, on the background Reclaimer if
+         * the tree had deferred destruction on when the cursor was made.
+         */
+        ~Cursor() {
+            if (deferred && snapshot != nullptr) {
+                reclaimInBackground(std::vector<Node*>(1, snapshot));
+            } else {
+                clear(snapshot);
+            }
+        }
+
+        /**
+         * Check if every key has been handed out.
+         *
+         * @return True if the traversal is finished
+         *         False if there are keys left
+         */
+        bool done() const {
+            return stack.empty();
+        }
+
+        /**
+         * Replaces the contents of chunk with the next keys in order.
+         *
+         * @param chunk   Vector to fill with keys
+         * @param maxKeys Largest number of keys to hand out
+         * @return        Number of keys handed out, 0 once finished
+         */
+        std::size_t nextChunk(std::vector<KeyType> &chunk,
+                              std::size_t maxKeys) {
+            chunk.clear();
+            while (chunk.size() < maxKeys && !done()) {
+                chunk.push_back(nextNode()->key);
+            }
+            return chunk.size();
+        }
+
+        /**
+         * Writes the next keys in order to an output stream, in the same
+         * format as getInOrderTraversal.
+         *
+         * @param out     Output stream
+         * @param maxKeys Largest number of keys to write
+         * @return        Number of keys written, 0 once finished
+         */
+        std::size_t writeChunk(std::ostream &out, std::size_t maxKeys) {
+            std::size_t written = 0;
+            while (written < maxKeys && !done()) {
+                out << nextNode()->key << " ";
+                written++;
+            }
+            return written;
+        }
+
+    private:
+        Node *snapshot;     // Root of the tree when the cursor was made
+        bool deferred;      // True to release snapshot in the background
+        InOrderStack stack; // Next node to hand out and the ones after it
+
+        /**
+         * Steps to the next node in order.
+         *
+         * @return Next node
+         */
+        Node *nextNode() {
+            Node *current = stack.top();
+            stack.next();
+            return current;
+        }
+    };
+
+    /**
+     * Returns a cursor positioned before the smallest key.
+     *
+     * @return In-order cursor over the current contents of the tree
+     */
+    Cursor getInOrderCursor() const {
+        return Cursor(*this);
+    }
+
+#ifdef BST_HAS_COROUTINES
+    /**
+     * Returns a generator which yields the keys in order, a chunk at a time.
+     * Like a Cursor, it traverses the tree as it was when this was called.
+     *
+     * @param chunkSize Largest number of keys per chunk
+     * @return          Generator of chunks of keys
+     */
+    Generator<std::vector<KeyType> > getInOrderChunks(
+            std::size_t chunkSize) const {
+        return generateChunks(Cursor(*this), chunkSize);
+    }
+#endif
+
+protected:
+    Node *root;              // Root of the tree
+    std::vector<Node*> path; // Scratch space for the path of a write
+
+    /**
+     * Constructor - initializes root.
+     */
+    BSTBase() : root(nullptr), reclaimPerWrite(0) {};
+
+    /**
+     * Copy constructor - creates copy of the tree which shares its nodes
+     * with the other tree until either of them changes. The copy uses the
+     * same deferred destruction setting, but starts with nothing to reclaim.
+     *
+     * @param other BSTBase object to copy
+     */
+    BSTBase(const BSTBase<KeyType, NodeType> &other)
+            : root(other.root), reclaimPerWrite(other.reclaimPerWrite) {
+        retain(root);
+    }
+
+    /**
+     * Overloaded assignment operator - releases current tree and shares the
+     * nodes of the other tree.
+     *
+     * @param rhs BSTBase object to copy (on right hand side of operator).
+     * @return    This BSTBase
+     */
+    BSTBase<KeyType, NodeType> &operator=(
+            const BSTBase<KeyType, NodeType> &rhs) {
+        // Retain first, in case both trees already share the same root
+        retain(rhs.root);
+        release(root);
+        root = rhs.root;
+        return *this;
+    }
+
+    /**
+     * Destructor - calls helper method, clear, and deletes any detached
+     * nodes. With deferred destruction on, the root and the detached nodes
+     * are handed to the background Reclaimer instead, so the destructor
+     * takes O(1) time however large the tree is.
+     */
+    ~BSTBase() {
+        if (reclaimPerWrite > 0) {
+            if (root != nullptr) {
+                detached.push_back(root);
+            }
+            if (!detached.empty()) {
+                reclaimInBackground(std::move(detached));
+            }
+        } else {
+            clear(root);
+            while (!detached.empty()) {
+                clear(detached.back());
+                detached.pop_back();
+            }
+        }
+    }
+
+    /**
+     * Deletes a few detached nodes, if deferred destruction is on. Called at
+     * the start of every write.
+     */
+    void reclaimSome() {
+        if (!detached.empty()) {
+            reclaim(reclaimPerWrite);
+        }
+    }
+
+    /**
+     * Allocates a new node. Every node in the tree is allocated here and
+     * freed by destroy.
+     *
+     * @param args Arguments for the node constructor
+     * @return     New node
+     */
+    template<typename... Args>
+    static Node *create(Args&&... args) {
+        return new Node(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Frees a node allocated by create. The node's children are not touched,
+     * so they must have been moved elsewhere or released first.
+     *
+     * @param node Node to free
+     */
+    static void destroy(Node *node) {
+        delete node;
+    }
+
+    /**
+     * Adds a link to a node.
+     *
+     * @param node Node being linked to (may be nullptr)
+     */
+    static void retain(Node *node) {
+        if (node != nullptr) {
+            // The caller already holds a link, so no ordering is needed
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Makes sure a node is not shared with another tree, so that it can be
+     * changed. A shared node is copied; the copy links to the same children
+     * (which become shared in turn) and the caller's link is moved from the
+     * original to the copy. The node must be reached through nodes which
+     * have already been owned, starting from the root. If the other trees
+     * let go of the original in the meantime, releasing the caller's link
+     * deletes it.
+     *
+     * @param current Node the caller is about to change (may be nullptr)
+     * @return        Node to change and link to in place of current
+     */
+    static Node *own(Node *current) {
+        // Acquire, so writes made by a tree which released the node before
+        // it became unshared are visible here
+        if (current == nullptr ||
+            current->refs.load(std::memory_order_acquire) == 1) {
+            return current;
+        }
+
+        Node *node = create(*current);
+        retain(node->left);
+        retain(node->right);
+        clear(current);
+        return node;
+    }
+
+    /**
+     * Searches for a key, returning the link that points to its node, or the
+     * null link where a node with the key would be added. Lets a caller look
+     * a key up and then add, update or unlink it without a second descent.
+     * Every node on the way, including the key's node, is owned. Counts as
+     * a write for deferred destruction.
+     *
+     * @param key  Key to search for
+     * @param path If not nullptr, the nodes above the key's node (or above
+     *             the null link) are appended to it, root first
+     * @return     Link to the key's node, or to null if not found
+     */
+    Node **findLink(const KeyType &key, std::vector<Node*> *path = nullptr) {
+        reclaimSome();
+        Node **link = &root;
+        while (*link != nullptr) {
+            Node *current = *link = own(*link);
+            if (key < current->key) {
+                link = &current->left;
+            } else if (key > current->key) {
+                link = &current->right;
+            } else {
+                break;
+            }
+            if (path != nullptr) {
+                path->push_back(current);
+            }
+        }
+        return link;
+    }
+
+    /**
+     * Searches for a key without changing anything, so that a write which
+     * turns out to change nothing doesn't copy any nodes. The nodes visited
+     * are appended to nodes, root first: every node down to the key's node,
+     * or down to the parent of the null link where it would be added.
+     *
+     * @param key   Key to search for
+     * @param nodes Vector to append the nodes visited to
+     * @return      True if found
+     *              False if not found
+     */
+    bool findPath(const KeyType &key, std::vector<Node*> &nodes) const {
+        Node *current = root;
+        while (current != nullptr) {
+            nodes.push_back(current);
+            if (key < current->key) {
+                current = current->left;
+            } else if (key > current->key) {
+                current = current->right;
+            } else {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Owns the nodes visited by findPath, once the write is known to change
+     * the tree, and replaces them in nodes with the owned nodes. Nothing may
+     * change the tree in between. Each step follows the pointer to the next
+     * node on the path, so only the last node's key is compared.
+     *
+     * @param key   Key findPath searched for
+     * @param nodes Nodes appended by findPath
+     * @return      Link to the key's node, or to null if not found
+     */
+    Node **ownPath(const KeyType &key, std::vector<Node*> &nodes) {
+        Node **link = &root;
+        for (std::size_t i = 0; i < nodes.size(); i++) {
+            Node *current = nodes[i] = *link = own(*link);
+            if (i + 1 < nodes.size()) {
+                // A copy links to the same children as the original
+                link = current->left == nodes[i + 1] ? &current->left
+                                                     : &current->right;
+            } else if (key < current->key) {
+                link = &current->left;
+            } else if (key > current->key) {
+                link = &current->right;
+            }
+        }
+        return link;
+    }
+
+    /**
+     * Searches for a key.
+     *
+     * @param key Key to search for
+     * @return    Node holding the key, or nullptr if not found
+     */
+    Node *findNode(const KeyType &key) const {
+        Node *current = root;
+        while (current != nullptr) {
+            if (key < current->key) {
+                current = current->left;
+            } else if (key > current->key) {
+                current = current->right;
+            } else {
+                break;
+            }
+        }
+        return current;
+    }
+
+    /**
+     * Unlinks a node from the tree without freeing it. A node with two
+     * children is replaced by the max node of its left subtree, which is
+     * moved rather than copied, so every other node (and its key and value)
+     * stays where it is in memory.
+     *
+     * @param link    Link to an owned node to unlink (must not point to null)
+     * @param maxPath If not nullptr and the node had two children, the nodes
+     *                between the node and the max node of its left subtree
+     *                (which lose that max node) are appended to it
+     * @return        Unlinked node
+     */
+    static Node *unlink(Node **link, std::vector<Node*> *maxPath = nullptr) {
+        Node *current = *link;
+        if (current->left == nullptr) {
+            // Replace the current node with its right child
+            *link = current->right;
+        } else if (current->right == nullptr) {
+            // Replace the current node with its left child
+            *link = current->left;
+        } else {
+            // Find max value node from the left subtree and move it into
+            // the current node's place (it has no right child)
+            Node **maxLink = &current->left;
+            *maxLink = own(*maxLink);
+            while ((*maxLink)->right != nullptr) {
+                if (maxPath != nullptr) {
+                    maxPath->push_back(*maxLink);
+                }
+                maxLink = &(*maxLink)->right;
+                *maxLink = own(*maxLink);
+            }
+            Node *max = *maxLink;
+            *maxLink = max->left;
+            max->left = current->left;
+            max->right = current->right;
+            *link = max;
+        }
+        current->left = current->right = nullptr;
+        return current;
+    }
+
+#ifdef BST_HAS_COROUTINES
+    /**
+     * Coroutine behind getInOrderChunks. It is static and owns its cursor,
+     * so it doesn't depend on the tree object staying alive.
+     *
+     * @param cursor    Cursor to take the keys from
+     * @param chunkSize Largest number of keys per chunk
+     * @return          Generator of chunks of keys
+     */
+    static Generator<std::vector<KeyType> > generateChunks(
+            Cursor cursor, std::size_t chunkSize) {
+        std::vector<KeyType> chunk;
+        while (cursor.nextChunk(chunk, chunkSize) > 0) {
+            co_yield chunk;
+        }
+    }
+#endif
+
+    /**
+     * Recursive helper method for size.
+     *
+     * @param current Subtree to find size of
+     * @return        Number of nodes in the tree
+     */
+    static int size(Node *current) {
+        // Once a null node is reached, stop traversing sub-tree
+        if (current == nullptr) {
+            // Adds 0 to recursive sum, indicating the current sub-tree is empty
+            return 0;
+        }
+
+        // Return size of left and right sub-trees, plus 1 to represent
+        // current node
+        return size(current->left) + 1 + size(current->right);
+    }
+
+    /**
+     * Recursive helper method for getLeafCount.
+     *
+     * @param current Subtree in which to find number of leaves
+     * @return        Number of leaf nodes
+     */
+    static int getLeafCount(Node *current) {
+        // Once null node is reached, stop traversing sub-tree
+        if (current == nullptr) {
+            // Adds 0 to recursive sum -> empty sub-tree implies no leaves
+            return 0;
+        }
+
+        // Leaf node must have no left child and no right child
+        if (current->left == nullptr && current->right == nullptr) {
+            // 1 is added to recursive sum, meaning a leaf was found
+            return 1;
+        } else {
+            // Get the leaf count of the left sub-tree and the right sub-tree
+            return getLeafCount(current->left) + getLeafCount(current->right);
+        }
+    }
+
+    /**
+     * Recursive helper method for getHeight.
+     *
+     * @param current Subtree to find height of
+     * @return        Height of the tree
+     */
+    static int getHeight(Node *current) {
+        // If null node is reached, don't add anything to the recursive sum
+        if (current == nullptr) {
+            return 0;
+        } else {
+            // Return 1 (to represent current node being visited) plus the
+            // height of the subtree which has the greater height
+            return 1 + std::max(getHeight(current->left),
+                                getHeight(current->right));
+        }
+    }
+
+    /**
+     * Recursive helper method for getWidth that returns the width of an
+     * individual level of the tree.
+     *
+     * @param current       Current node being visited
+     * @param remainingLvls Initially represents the level to get the width of.
+     *                      While recursing down the tree, it represents how
+     *                      many levels are left to go down until we reach
+     *                      the level we would like to obtain the width of.
+     * @return              Width of the level
+     */
+    static int getLevelWidth(Node *current, int remainingLvls) {
+        // Don't add anything to recursive sum if null node is reached
+        if (current == nullptr) {
+            return 0;
+        }
+        // If there are no more levels left to go down (or case where root is
+        // the only node)
+        if (remainingLvls == 0) {
+            // Adds 1 to recursive sum to represent the current visited node
+            return 1;
+        } else {
+            // Start at root and walk down the tree with each recursive call
+            // until no more levels are left to go down (remainingLvls == 0)
+            return getLevelWidth(current->left, remainingLvls - 1) +
+                   getLevelWidth(current->right, remainingLvls - 1);
+        }
+    }
+
+    /**
+     * Recursive helper method for getInOrderTraversal.
+     *
+     * @param current Subtree to traverse, in-order
+     * @param ss      Output string stream
+     */
+    static void getInOrderTraversal(Node *current, std::ostringstream &ss) {
+        if (current == nullptr)  {
+            return;
+        }
+
+        // Print left, current, then right node to string stream
+        getInOrderTraversal(current->left, ss);
+        ss << current->key << " ";
+        getInOrderTraversal(current->right, ss);
+    }
+
+    /**
+     * Recursive helper method for getPreOrderTraversal.
+     *
+     * @param current Subtree to traverse, pre-order
+     * @param ss      Output string stream
+     */
+    static void getPreOrderTraversal(Node *current, std::ostringstream &ss) {
+        if (current == nullptr)  {
+            return;
+        }
+
+        // Print current, left, then right node to string stream
+        ss << current->key << " ";
+        getPreOrderTraversal(current->left, ss);
+        getPreOrderTraversal(current->right, ss);
+    }
+
+    /**
+     * Recursive helper method for getPostOrderTraversal.
+     *
+     * @param current Subtree to traverse, post-order
+     * @param ss      Output string stream
+     */
+    static void getPostOrderTraversal(Node *current, std::ostringstream &ss) {
+        if (current == nullptr)  {
+            return;
+        }
+
+        // Print left, right, then current node to string stream
+        getPostOrderTraversal(current->left, ss);
+        getPostOrderTraversal(current->right, ss);
+        ss << current->key << " ";
+    }
+
+    /**
+     * Releases the tree's link to a subtree, either right away or, with
+     * deferred destruction on, by detaching it for reclaim.
+     *
+     * @param current Root of the subtree to release
+     */
+    void release(Node *current) {
+        if (current == nullptr) {
+            return;
+        }
+        if (reclaimPerWrite > 0) {
+            detached.push_back(current);
+        } else {
+            clear(current);
+        }
+    }
+
+    /**
+     * Helper method for reclaim. Releases links to subtrees, deleting the
+     * nodes no other tree links to, up to the given budget. Works from an
+     * explicit stack rather than recursing, so it can be stopped anywhere.
+     *
+     * @param pending Released links; children of deleted nodes are pushed
+     *                onto it and links are popped as they are released
+     * @param budget  Largest number of nodes to visit
+     * @return        Number of nodes deleted
+     */
+    static std::size_t reclaim(std::vector<Node*> &pending,
+                               std::size_t budget) {
+        std::size_t deleted = 0;
+        for (; budget > 0 && !pending.empty(); budget--) {
+            Node *current = pending.back();
+            pending.pop_back();
+            if (current->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                if (current->left != nullptr) {
+                    pending.push_back(current->left);
+                }
+                if (current->right != nullptr) {
+                    pending.push_back(current->right);
+                }
+                destroy(current);
+                deleted++;
+            }
+        }
+        return deleted;
+    }
+
+    /**
+     * Hands released links to the background Reclaimer, which deletes the
+     * nodes no other tree links to.
+     *
+     * @param pending Released links
+     */
+    static void reclaimInBackground(std::vector<Node*> pending) {
+        Reclaimer::instance().submit([pending = std::move(pending)]() mutable {
+            reclaim(pending, SIZE_MAX);
+        });
+    }
+
+    /**
+     * Recursive helper method to release a link to a subtree, deleting the
+     * nodes no other tree links to.
+     *
+     * @param current Root of the subtree to release
+     */
+    static void clear(Node *current) {
+        if (current != nullptr &&
+            current->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            clear(current->left);
+            clear(current->right);
+            destroy(current);
+        }
+    }
+
+private:
+    std::vector<Node*> detached; // Released links whose nodes await deletion
+    std::size_t reclaimPerWrite; // Nodes deleted per write, 0 if not deferred
+};
@@ -0,0 +1,410 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+#include <vector>
+#include "BSTBase.h"
+
+/*
+ * Node objects which make up a BSTMap
+ */
+template<typename KeyType, typename ValueType>
+struct BSTMapNode {
+    KeyType key;
+    ValueType value;
+    std::atomic<int> refs;    // Number of links to this node
+    BSTMapNode *left, *right; // Left and right child
+
+    /**
+     * Node constructor.
+     *
+     * @param key  Key of the node
+     * @param args Arguments for the value constructor
+     */
+    template<typename... Args>
+    explicit BSTMapNode(const KeyType &key, Args&&... args)
+            : key(key), value(std::forward<Args>(args)...), refs(1),
+              left(nullptr), right(nullptr) {}
+
+    /**
+     * Node copy constructor - copies the key and value and links to the
+     * same children. The copy starts with a single link to it.
+     *
+     * @param other Node to copy
+     */
+    BSTMapNode(const BSTMapNode &other)
+            : key(other.key), value(other.value), refs(1), left(other.left),
+              right(other.right) {}
+};
+
+/**
+ * Binary Search Tree map template class, mapping each key to a value. It
+ * shares its nodes' allocation, copying, searching and traversal methods with
+ * BST through BSTBase. Each of operator[], insert_or_assign, try_emplace,
+ * find and erase descends the tree once, and an iterator returned by find
+ * can be used to read or update the value, or to erase the entry (updating
+ * and erasing find the entry again by key, a single descent).
+ *
+ * Iterators visit keys in order. There are no parent links (nodes can be
+ * shared by several maps), so an iterator holds its entry and the ancestors
+ * whose keys come after it (BSTBase::InOrderStack), and stepping to the next
+ * entry takes O(1) time on average.
+ *
+ * Copies share nodes until written to (see BSTBase). Getting, moving and
+ * reading through an iterator never copies anything; * and -> only read the
+ * value, and writing goes through value(), which finds the entry again by
+ * key and makes it and the nodes above it private to the iterator's map, so
+ * a write never shows up in a copy, even one made after the iterator was.
+ *
+ * Erasing an entry can move other entries' nodes, so it invalidates every
+ * iterator except the one erase returns. On a map which shares no nodes,
+ * nothing else invalidates iterators. While a map shares nodes with a copy,
+ * any other write to it (adding an entry, operator[], insert_or_assign, or
+ * value() through another iterator) can replace the nodes an iterator holds
+ * with private copies, and reading or stepping that iterator may then see
+ * the copy's entries instead. value() and erase still work through it,
+ * since they find the entry by key, as long as the copy still exists; to
+ * read it again, find the key again.
+ *
+ * @tparam  KeyType   Data type of the key
+ * @tparam  ValueType Data type of the value
+ * @author  Francis Kogge
+ * @version 1.0
+ * @date    12/09/2020
+ */
+template<typename KeyType, typename ValueType>
+class BSTMap : public BSTBase<KeyType, BSTMapNode<KeyType, ValueType> > {
+    typedef BSTBase<KeyType, BSTMapNode<KeyType, ValueType> > Base;
+    typedef typename Base::Node Node;
+    using Base::root;
+    using Base::path;
+    using Base::create;
+    using Base::destroy;
+
+    /*
+     * Iterator over the entries of a BSTMap, in key order. MapType and
+     * Value are const for a const_iterator.
+     */
+    template<typename MapType, typename Value>
+    class Iterator {
+    public:
+        /**
+         * Constructor - creates an iterator which points nowhere.
+         */
+        Iterator() : map(nullptr) {}
+
+        /**
+         * Converting constructor - creates a const_iterator from an
+         * iterator.
+         *
+         * @param other Iterator to convert
+         */
+        template<typename OtherMap, typename OtherValue>
+        Iterator(const Iterator<OtherMap, OtherValue> &other)
+                : map(other.map), stack(other.stack) {}
+
+        /**
+         * Returns the key of the entry.
+         *
+         * @return Key of the entry
+         */
+        const KeyType &key() const {
+            return stack.top()->key;
+        }
+
+        /**
+         * Returns the value of the entry, to read or write. Through an
+         * iterator (not a const_iterator), the entry is first made private to
+         * the map, copying it and the nodes above it if they are shared with
+         * a copy of the map.
+         *
+         * @return Value of the entry
+         */
+        Value &value() {
+            map->ownEntry(stack);
+            return stack.top()->value;
+        }
+
+        /**
+         * Returns the value of the entry, to read.
+         *
+         * @return Value of the entry
+         */
+        const ValueType &operator*() const {
+            return stack.top()->value;
+        }
+
+        /**
+         * Accesses a member of the value of the entry, to read.
+         *
+         * @return Pointer to the value of the entry
+         */
+        const ValueType *operator->() const {
+            return &stack.top()->value;
+        }
+
+        /**
+         * Moves to the entry with the next key.
+         *
+         * @return This iterator
+         */
+        Iterator &operator++() {
+            stack.next();
+            return *this;
+        }
+
+        /**
+         * Moves to the entry with the next key.
+         *
+         * @return Copy of this iterator from before it moved
+         */
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        /**
+         * Checks if two iterators point to the same entry.
+         *
+         * @param rhs Iterator to compare with
+         * @return    True if they point to the same entry
+         */
+        bool operator==(const Iterator &rhs) const {
+            return stack.top() == rhs.stack.top();
+        }
+
+        /**
+         * Checks if two iterators point to different entries.
+         *
+         * @param rhs Iterator to compare with
+         * @return    True if they point to different entries
+         */
+        bool operator!=(const Iterator &rhs) const {
+            return stack.top() != rhs.stack.top();
+        }
+
+    private:
+        template<typename, typename> friend class Iterator;
+        friend class BSTMap;
+
+        MapType *map;                      // Map being iterated over
+        typename Base::InOrderStack stack; // Current entry and the ones
+                                           // after it, empty at the end
+
+        /**
+         * Constructor - creates an end iterator, for a position to be set.
+         *
+         * @param map Map being iterated over
+         */
+        explicit Iterator(MapType *map) : map(map) {}
+    };
+
+public:
+    typedef Iterator<BSTMap, ValueType> iterator;
+    typedef Iterator<const BSTMap, const ValueType> const_iterator;
+
+    /**
+     * Returns an iterator to the entry with the smallest key.
+     *
+     * @return Iterator to the first entry, or end() if empty
+     */
+    iterator begin() {
+        iterator first(this);
+        first.stack.pushLeftPath(root);
+        return first;
+    }
+
+    /**
+     * Returns an iterator to the entry with the smallest key.
+     *
+     * @return Iterator to the first entry, or end() if empty
+     */
+    const_iterator begin() const {
+        const_iterator first(this);
+        first.stack.pushLeftPath(root);
+        return first;
+    }
+
+    /**
+     * Returns an iterator past the entry with the largest key.
+     *
+     * @return End iterator
+     */
+    iterator end() {
+        return iterator(this);
+    }
+
+    /**
+     * Returns an iterator past the entry with the largest key.
+     *
+     * @return End iterator
+     */
+    const_iterator end() const {
+        return const_iterator(this);
+    }
+
+    /**
+     * Check if the given key is present in the map.
+     *
+     * @param key Key to check
+     * @return    True if it is present
+     *            False if it is not present
+     */
+    bool has(const KeyType &key) const {
+        return Base::findNode(key) != nullptr;
+    }
+
+    /**
+     * Finds the entry with the given key.
+     *
+     * @param key Key to search for
+     * @return    Iterator to the entry, or end() if not found
+     */
+    iterator find(const KeyType &key) {
+        iterator found(this);
+        found.stack.find(root, key);
+        return found;
+    }
+
+    /**
+     * Finds the entry with the given key.
+     *
+     * @param key Key to search for
+     * @return    Iterator to the entry, or end() if not found
+     */
+    const_iterator find(const KeyType &key) const {
+        const_iterator found(this);
+        found.stack.find(root, key);
+        return found;
+    }
+
+    /**
+     * Returns the value for the given key, adding an entry with a default
+     * constructed value if the key is not present.
+     *
+     * @param key Key to look up
+     * @return    Value for the key
+     */
+    ValueType &operator[](const KeyType &key) {
+        Node **link = Base::findLink(key);
+        if (*link == nullptr) {
+            *link = create(key);
+        }
+        return (*link)->value;
+    }
+
+    /**
+     * Adds an entry with a value constructed from the given arguments. If the
+     * key is already present, its value is left alone and the arguments are
+     * not used.
+     *
+     * @param key  Key to add
+     * @param args Arguments for the value constructor
+     * @return     Iterator to the entry with the key, and true if it was
+     *             added (false if the key was already present)
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const KeyType &key, Args&&... args) {
+        iterator entry(this);
+        Base::reclaimSome();
+        path.clear();
+        bool added = !Base::findPath(key, path);
+        if (added) {
+            // Only copy shared nodes once the key is known to be new
+            Node **link = Base::ownPath(key, path);
+            *link = create(key, std::forward<Args>(args)...);
+            path.push_back(*link);
+        }
+        entry.stack.assign(path);
+        return std::make_pair(entry, added);
+    }
+
+    /**
+     * Adds an entry with the given value, or assigns the value to the entry
+     * if the key is already present.
+     *
+     * @param key   Key to add or update
+     * @param value Value for the key
+     * @return      Iterator to the entry with the key, and true if it was
+     *              added (false if it was updated)
+     */
+    template<typename Value>
+    std::pair<iterator, bool> insert_or_assign(const KeyType &key,
+                                               Value &&value) {
+        iterator entry(this);
+        path.clear();
+        Node **link = Base::findLink(key, &path);
+        bool added = *link == nullptr;
+        if (added) {
+            *link = create(key, std::forward<Value>(value));
+        } else {
+            (*link)->value = std::forward<Value>(value);
+        }
+        path.push_back(*link);
+        entry.stack.assign(path);
+        return std::make_pair(entry, added);
+    }
+
+    /**
+     * Removes the entry an iterator points to. The tree is descended once,
+     * by the entry's key, and the returned iterator is positioned on the way.
+     *
+     * @param position Iterator to the entry to remove (not end())
+     * @return         Iterator to the entry after the removed one
+     */
+    iterator erase(const_iterator position) {
+        // Copy the key, owning the path can release the node holding it
+        KeyType key = position.key();
+        iterator next(this);
+        path.clear();
+        Node **link = Base::findLink(key, &path);
+        path.push_back(*link);
+        next.stack.assign(path);
+        // Step past the entry before unlinking it; its right subtree and the
+        // ancestors after it stay where they are
+        next.stack.next();
+        destroy(Base::unlink(link));
+        return next;
+    }
+
+    /**
+     * Removes the entry with the given key.
+     *
+     * @param key Key to remove
+     * @return    Number of entries removed (0 or 1)
+     */
+    int erase(const KeyType &key) {
+        Base::reclaimSome();
+        path.clear();
+        if (!Base::findPath(key, path)) {
+            return 0;
+        }
+        destroy(Base::unlink(Base::ownPath(key, path)));
+        return 1;
+    }
+
+private:
+    /**
+     * Makes an iterator's entry private to this map, so its value can be
+     * written. The entry is found again by key, since a write through
+     * another iterator may have replaced the nodes the iterator holds.
+     *
+     * @param stack Position of the iterator, moved to the owned entry
+     */
+    void ownEntry(typename Base::InOrderStack &stack) {
+        // Copy the key, owning the path can release the node holding it
+        KeyType key = stack.top()->key;
+        path.clear();
+        Node **link = Base::findLink(key, &path);
+        path.push_back(*link);
+        stack.assign(path);
+    }
+
+    /**
+     * Does nothing, the entries of a const map are only read.
+     *
+     * @param stack Position of the iterator
+     */
+    void ownEntry(typename Base::InOrderStack &/* stack */) const {}
+};
\ No newline at end of file
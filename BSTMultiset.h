@@ -0,0 +1,234 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include "BSTBase.h"
+
+/*
+ * Node objects which make up a BSTMultiset
+ */
+template<typename KeyType>
+struct BSTMultisetNode {
+    KeyType key;
+    int count;                     // Number of occurrences of key
+    int total;                     // Number of occurrences in this subtree
+    std::atomic<int> refs;         // Number of links to this node
+    BSTMultisetNode *left, *right; // Left and right child
+
+    /**
+     * Node constructor - creates a node holding one occurrence of a key.
+     *
+     * @param key Key of the node
+     */
+    explicit BSTMultisetNode(const KeyType &key)
+            : key(key), count(1), total(1), refs(1), left(nullptr),
+              right(nullptr) {}
+
+    /**
+     * Node copy constructor - copies the key and counts and links to the
+     * same children. The copy starts with a single link to it.
+     *
+     * @param other Node to copy
+     */
+    BSTMultisetNode(const BSTMultisetNode &other)
+            : key(other.key), count(other.count), total(other.total), refs(1),
+              left(other.left), right(other.right) {}
+};
+
+/**
+ * Binary Search Tree multiset template class. Duplicate keys are kept, but
+ * rather than adding a node per duplicate, each node counts the occurrences
+ * of its key, so memory stays proportional to the number of distinct keys.
+ * size and rank count every occurrence; each node also keeps the total number
+ * of occurrences in its subtree, so size is O(1) and rank only descends the
+ * tree once. The shape, width and traversal methods (from BSTBase) see one
+ * node per distinct key.
+ *
+ * @tparam  KeyType Data type of the key
+ * @author  Francis Kogge
+ * @version 1.0
+ * @date    12/09/2020
+ */
+template<typename KeyType>
+class BSTMultiset : public BSTBase<KeyType, BSTMultisetNode<KeyType> > {
+    typedef BSTBase<KeyType, BSTMultisetNode<KeyType> > Base;
+    typedef typename Base::Node Node;
+    using Base::root;
+    using Base::path;
+    using Base::create;
+    using Base::destroy;
+
+public:
+    /**
+     * Adds one occurrence of a key to the tree.
+     *
+     * @param newKey Key to insert
+     */
+    void add(const KeyType &newKey) {
+        path.clear();
+        Node **link = Base::findLink(newKey, &path);
+        if (*link != nullptr) {
+            (*link)->count++;
+            (*link)->total++;
+        } else {
+            *link = create(newKey);
+        }
+        addToTotals(path, 1);
+    }
+
+    /**
+     * Check if the given key is present in the tree.
+     *
+     * @param key Key to check
+     * @return    True if it is present
+     *            False if it is not present
+     */
+    bool has(const KeyType &key) const {
+        return Base::findNode(key) != nullptr;
+    }
+
+    /**
+     * Returns the number of occurrences of a key.
+     *
+     * @param key Key to count
+     * @return    Number of occurrences, 0 if not present
+     */
+    int count(const KeyType &key) const {
+        Node *node = Base::findNode(key);
+        return node == nullptr ? 0 : node->count;
+    }
+
+    /**
+     * Removes one occurrence of a key. The key's node is deleted along with
+     * its last occurrence.
+     *
+     * @param key Key to remove
+     */
+    void remove(const KeyType &key) {
+        Base::reclaimSome();
+        path.clear();
+        if (!Base::findPath(key, path)) {
+            return;
+        }
+        Node **link = Base::ownPath(key, path);
+        path.pop_back(); // Leave the nodes above the key's node
+        if ((*link)->count == 1) {
+            removeNode(link);
+        } else {
+            (*link)->count--;
+            (*link)->total--;
+        }
+        addToTotals(path, -1);
+    }
+
+    /**
+     * Removes every occurrence of a key.
+     *
+     * @param key Key to remove
+     * @return    Number of occurrences removed
+     */
+    int removeAll(const KeyType &key) {
+        Base::reclaimSome();
+        path.clear();
+        if (!Base::findPath(key, path)) {
+            return 0;
+        }
+        Node **link = Base::ownPath(key, path);
+        path.pop_back(); // Leave the nodes above the key's node
+        int removed = (*link)->count;
+        removeNode(link);
+        addToTotals(path, -removed);
+        return removed;
+    }
+
+    /**
+     * Returns the size of the tree, counting every occurrence of each key.
+     *
+     * @return Number of keys in the tree
+     */
+    int size() const {
+        return total(root);
+    }
+
+    /**
+     * Returns the number of distinct keys (nodes) in the tree.
+     *
+     * @return Number of distinct keys
+     */
+    int getDistinctCount() const {
+        return Base::size();
+    }
+
+    /**
+     * Returns the rank of a key: the number of keys in the tree, counting
+     * every occurrence, which are less than the given key.
+     *
+     * @param key Key to find the rank of (need not be in the tree)
+     * @return    Number of keys less than key
+     */
+    int rank(const KeyType &key) const {
+        Node *current = root;
+        int less = 0;
+        while (current != nullptr) {
+            if (key < current->key) {
+                current = current->left;
+            } else if (key > current->key) {
+                // Current node and its left subtree are all less than key
+                less += total(current->left) + current->count;
+                current = current->right;
+            } else {
+                less += total(current->left);
+                break;
+            }
+        }
+        return less;
+    }
+
+private:
+    /**
+     * Returns the number of keys in a subtree, counting occurrences.
+     *
+     * @param current Subtree to find size of
+     * @return        Number of keys in the subtree
+     */
+    static int total(Node *current) {
+        return current == nullptr ? 0 : current->total;
+    }
+
+    /**
+     * Adds to the subtree totals of the given nodes.
+     *
+     * @param nodes  Owned nodes whose subtrees changed
+     * @param amount Number of occurrences added (negative if removed)
+     */
+    static void addToTotals(const std::vector<Node*> &nodes, int amount) {
+        for (std::size_t i = 0; i < nodes.size(); i++) {
+            nodes[i]->total += amount;
+        }
+    }
+
+    /**
+     * Unlinks and deletes a node, keeping the totals below its link right.
+     * The totals of the nodes above it (in path) are left to the caller.
+     *
+     * @param link Link to an owned node to remove
+     */
+    void removeNode(Node **link) {
+        Node *removed = *link;
+        std::size_t above = path.size();
+        int remaining = removed->total - removed->count;
+        bool replacedByMax = removed->left != nullptr &&
+                             removed->right != nullptr;
+        destroy(Base::unlink(link, &path));
+        if (replacedByMax) {
+            // The max node of the left subtree moved up from under the nodes
+            // unlink appended to path, and took over the removed subtree
+            Node *max = *link;
+            for (std::size_t i = above; i < path.size(); i++) {
+                path[i]->total -= max->count;
+            }
+            path.resize(above);
+            max->total = remaining;
+        }
+    }
+};
@@ -0,0 +1,432 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <sstream>
+#include <queue>
+#include <vector>
+
+/**
+ * Compact Binary Search Tree template class. It has the same interface as
+ * BST, but its nodes live in one contiguous vector and refer to their
+ * children by 32-bit index instead of by pointer. Slots freed by remove are
+ * kept on a free list and reused by later adds. For a 4-byte key a node takes
+ * 12 bytes with no per-node allocation, and copying the tree copies the
+ * vector in one go instead of rebuilding it node by node.
+ *
+ * The tree holds at most 2^31 - 1 nodes, so that its size fits in an int;
+ * add throws std::length_error when the tree is full.
+ *
+ * @tparam  KeyType Data type of the key
+ * @author  Francis Kogge
+ * @version 1.0
+ * @date    12/09/2020
+ */
+template<typename KeyType>
+class CompactBST {
+
+public:
+    /**
+     * Constructor - initializes an empty tree.
+     */
+    CompactBST() : root(NIL), freeList(NIL), count(0) {};
+
+    /**
+     * Reserves room for the given number of nodes, so a tree of known size
+     * can be built without reallocating the node vector.
+     *
+     * @param numNodes Number of nodes to make room for
+     */
+    void reserve(int numNodes) {
+        nodes.reserve(numNodes);
+    }
+
+    /**
+     * Insert a new element into the tree. If the element is already in the
+     * tree, this method does nothing.
+     *
+     * @param newKey Key to insert
+     * @throws std::length_error If the tree already holds MAX_NODES nodes
+     */
+    void add(const KeyType &newKey) {
+        Index parent = NIL, current = root;
+        // Walk down to the null link where the key belongs
+        while (current != NIL) {
+            parent = current;
+            if (newKey < nodes[current].key) {
+                current = nodes[current].left;
+            } else if (newKey > nodes[current].key) {
+                current = nodes[current].right;
+            } else {
+                // Key is already in the tree
+                return;
+            }
+        }
+
+        // Allocate before linking, since allocating may move the nodes
+        Index added = allocate(newKey);
+        if (parent == NIL) {
+            root = added;
+        } else if (newKey < nodes[parent].key) {
+            nodes[parent].left = added;
+        } else {
+            nodes[parent].right = added;
+        }
+    }
+
+    /**
+     * Check if the given key is present in the tree.
+     *
+     * @param key Key to check
+     * @return    True if it is present
+     *            False if it is not present
+     */
+    bool has(const KeyType &key) const {
+        Index current = root;
+        while (current != NIL) {
+            if (key < nodes[current].key) {
+                current = nodes[current].left;
+            } else if (key > nodes[current].key) {
+                current = nodes[current].right;
+            } else {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Removes the given key from the tree.
+     *
+     * @param key Key to remove
+     */
+    void remove(const KeyType &key) {
+        // Find the node to remove and the link pointing to it
+        Index *link = &root;
+        while (*link != NIL) {
+            if (key < nodes[*link].key) {
+                link = &nodes[*link].left;
+            } else if (key > nodes[*link].key) {
+                link = &nodes[*link].right;
+            } else {
+                break;
+            }
+        }
+        // Key is not in the tree
+        if (*link == NIL) {
+            return;
+        }
+
+        Index current = *link;
+        if (nodes[current].left == NIL) {
+            // Replace the current node with its right child
+            *link = nodes[current].right;
+            release(current);
+        } else if (nodes[current].right == NIL) {
+            // Replace the current node with its left child
+            *link = nodes[current].left;
+            release(current);
+        } else {
+            // Find max value node from the left subtree, move its key into
+            // the current node, then unlink it (it has no right child)
+            Index *maxLink = &nodes[current].left;
+            while (nodes[*maxLink].right != NIL) {
+                maxLink = &nodes[*maxLink].right;
+            }
+            Index max = *maxLink;
+            nodes[current].key = nodes[max].key;
+            *maxLink = nodes[max].left;
+            release(max);
+        }
+    }
+
+    /**
+     * Check if this tree is empty.
+     *
+     * @return True if empty
+     *         False if not empty
+     */
+    bool empty() const {
+        return root == NIL;
+    }
+
+    /**
+     * Returns the size the tree.
+     *
+     * @return Size of the tree
+     */
+    int size() const {
+        return count;
+    }
+
+    /**
+     * Returns the number of bytes used by the tree, including free slots and
+     * unused vector capacity.
+     *
+     * @return Bytes used by the tree
+     */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) + nodes.capacity() * sizeof(Node);
+    }
+
+    /**
+     * Returns the number of leaf nodes (node with no child nodes) in the tree.
+     *
+     * @return Number of leaf nodes in the tree
+     */
+    int getLeafCount() const {
+        return getLeafCount(root);
+    }
+
+    /**
+     * Returns the height of the tree.
+     *
+     * @return Height of the tree
+     */
+    int getHeight() const {
+        return getHeight(root);
+    }
+
+    /**
+     * Returns the width of the tree (the largest number of nodes in the same
+     * level).
+     *
+     * @return Width of the tree
+     */
+    int getWidth() const {
+        int height = getHeight(root), maxWidth = 0;
+        // Iterate through each level of the tree
+        for (int level = 0; level < height; level++) {
+            // Get the current level width
+            maxWidth = std::max(getLevelWidth(root, level), maxWidth);
+        }
+        return maxWidth;
+    }
+
+    /**
+     * Returns a string representing the in-order traversal.
+     *
+     * @return Key of each node, in-order
+     */
+    std::string getInOrderTraversal() const {
+        std::ostringstream ss;
+        getInOrderTraversal(root, ss);
+        return ss.str();
+    }
+
+    /**
+     * Returns a string representing the pre-order traversal.
+     *
+     * @return Key of each node, pre-order
+     */
+    std::string getPreOrderTraversal() const {
+        std::ostringstream ss;
+        getPreOrderTraversal(root, ss);
+        return ss.str();
+    }
+
+    /**
+     * Returns a string representing the post-order traversal.
+     *
+     * @return Key of each node, post-order
+     */
+    std::string getPostOrderTraversal() const {
+        std::ostringstream ss;
+        getPostOrderTraversal(root, ss);
+        return ss.str();
+    }
+
+    /**
+     * Returns a string representing the level-order traversal.
+     *
+     * @return Key of each node, level-order
+     */
+    std::string getLevelOrderTraversal() const {
+        std::ostringstream ss;
+        // Queue of node indices to keep track of order to print
+        std::queue<Index> pending;
+        if (!empty()) {
+            pending.push(root);
+        }
+
+        while (!pending.empty()) {
+            const Node &current = nodes[pending.front()];
+            ss << current.key << " ";
+            if (current.left != NIL) {
+                pending.push(current.left);
+            }
+            if (current.right != NIL) {
+                pending.push(current.right);
+            }
+            pending.pop();
+        }
+        return ss.str();
+    }
+
+private:
+    typedef std::uint32_t Index;
+    static const Index NIL = 0xFFFFFFFFu;       // Index standing in for nullptr
+    static const Index MAX_NODES = 0x7FFFFFFFu; // Largest number of slots
+
+    /*
+     * Node objects which make up the binary search tree. A node on the free
+     * list links to the next free node through left.
+     */
+    struct Node {
+        KeyType key;
+        Index left, right; // Left and right child
+
+        /**
+         * Node constructor.
+         *
+         * @param key Key of the node
+         */
+        explicit Node(const KeyType &key) : key(key), left(NIL), right(NIL) {}
+    };
+
+    std::vector<Node> nodes; // Node storage, indexed by Index
+    Index root;              // Root of the tree
+    Index freeList;          // First free slot in nodes
+    int count;               // Number of nodes in the tree
+
+    /**
+     * Stores a new leaf node, reusing a free slot if there is one.
+     *
+     * @param key Key of the new node
+     * @return    Index of the new node
+     * @throws std::length_error If every one of MAX_NODES slots is in use
+     */
+    Index allocate(const KeyType &key) {
+        Index added;
+        if (freeList != NIL) {
+            added = freeList;
+            freeList = nodes[added].left;
+            nodes[added] = Node(key);
+        } else {
+            if (nodes.size() >= MAX_NODES) {
+                throw std::length_error("CompactBST: too many nodes");
+            }
+            added = static_cast<Index>(nodes.size());
+            nodes.push_back(Node(key));
+        }
+        count++;
+        return added;
+    }
+
+    /**
+     * Puts a node's slot on the free list. The key is reset so that a free
+     * slot doesn't hold on to memory owned by the key (a string's buffer,
+     * for example).
+     *
+     * @param index Index of the node to free
+     */
+    void release(Index index) {
+        nodes[index].key = KeyType();
+        nodes[index].left = freeList;
+        freeList = index;
+        count--;
+    }
+
+    /**
+     * Recursive helper method for getLeafCount.
+     *
+     * @param current Subtree in which to find number of leaves
+     * @return        Number of leaf nodes
+     */
+    int getLeafCount(Index current) const {
+        if (current == NIL) {
+            return 0;
+        }
+
+        const Node &node = nodes[current];
+        if (node.left == NIL && node.right == NIL) {
+            return 1;
+        } else {
+            return getLeafCount(node.left) + getLeafCount(node.right);
+        }
+    }
+
+    /**
+     * Recursive helper method for getHeight.
+     *
+     * @param current Subtree to find height of
+     * @return        Height of the tree
+     */
+    int getHeight(Index current) const {
+        if (current == NIL) {
+            return 0;
+        } else {
+            return 1 + std::max(getHeight(nodes[current].left),
+                                getHeight(nodes[current].right));
+        }
+    }
+
+    /**
+     * Recursive helper method for getWidth that returns the width of an
+     * individual level of the tree.
+     *
+     * @param current       Current node being visited
+     * @param remainingLvls Number of levels left to go down
+     * @return              Width of the level
+     */
+    int getLevelWidth(Index current, int remainingLvls) const {
+        if (current == NIL) {
+            return 0;
+        }
+        if (remainingLvls == 0) {
+            return 1;
+        } else {
+            return getLevelWidth(nodes[current].left, remainingLvls - 1) +
+                   getLevelWidth(nodes[current].right, remainingLvls - 1);
+        }
+    }
+
+    /**
+     * Recursive helper method for getInOrderTraversal.
+     *
+     * @param current Subtree to traverse, in-order
+     * @param ss      Output string stream
+     */
+    void getInOrderTraversal(Index current, std::ostringstream &ss) const {
+        if (current == NIL) {
+            return;
+        }
+
+        getInOrderTraversal(nodes[current].left, ss);
+        ss << nodes[current].key << " ";
+        getInOrderTraversal(nodes[current].right, ss);
+    }
+
+    /**
+     * Recursive helper method for getPreOrderTraversal.
+     *
+     * @param current Subtree to traverse, pre-order
+     * @param ss      Output string stream
+     */
+    void getPreOrderTraversal(Index current, std::ostringstream &ss) const {
+        if (current == NIL) {
+            return;
+        }
+
+        ss << nodes[current].key << " ";
+        getPreOrderTraversal(nodes[current].left, ss);
+        getPreOrderTraversal(nodes[current].right, ss);
+    }
+
+    /**
+     * Recursive helper method for getPostOrderTraversal.
+     *
+     * @param current Subtree to traverse, post-order
+     * @param ss      Output string stream
+     */
+    void getPostOrderTraversal(Index current, std::ostringstream &ss) const {
+        if (current == NIL) {
+            return;
+        }
+
+        getPostOrderTraversal(nodes[current].left, ss);
+        getPostOrderTraversal(nodes[current].right, ss);
+        ss << nodes[current].key << " ";
+    }
+};
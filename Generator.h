@@ -0,0 +1,173 @@
+#pragma once
+
+/*
+ * Generator is only available when compiling as C++20 (or later) with
+ * coroutine support, in which case BST_HAS_COROUTINES is defined. The build
+ * uses C++14, where BSTBase::Cursor offers the same chunked traversal
+ * without coroutines.
+ */
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <utility>
+
+#define BST_HAS_COROUTINES 1
+
+/**
+ * Minimal generator for coroutines which co_yield values of type T. The
+ * coroutine runs lazily: each call to next (or each step of a range-based for
+ * loop) resumes it until it yields the next value or returns.
+ *
+ * @tparam  T Data type of the yielded values
+ * @author  Francis Kogge
+ * @version 1.0
+ * @date    12/09/2020
+ */
+template<typename T>
+class Generator {
+
+public:
+    /*
+     * Coroutine promise, holding a pointer to the last yielded value
+     */
+    struct promise_type {
+        const T *current = nullptr;
+        std::exception_ptr error;
+
+        Generator get_return_object() {
+            return Generator(Handle::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+        std::suspend_always yield_value(const T &value) noexcept {
+            current = &value;
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() {
+            error = std::current_exception();
+        }
+    };
+
+    /*
+     * Input iterator over the yielded values, for range-based for loops
+     */
+    class iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        explicit iterator(Generator *generator = nullptr)
+                : generator(generator) {}
+
+        const T &operator*() const {
+            return generator->value();
+        }
+
+        iterator &operator++() {
+            if (!generator->next()) {
+                generator = nullptr;
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator &rhs) const {
+            return generator == rhs.generator;
+        }
+
+        bool operator!=(const iterator &rhs) const {
+            return generator != rhs.generator;
+        }
+
+    private:
+        Generator *generator; // Generator being iterated, nullptr at the end
+    };
+
+    /**
+     * Move constructor - takes over the other generator's coroutine.
+     *
+     * @param other Generator to move from
+     */
+    Generator(Generator &&other) noexcept
+            : handle(std::exchange(other.handle, nullptr)) {}
+
+    Generator(const Generator &other) = delete;
+    Generator &operator=(const Generator &rhs) = delete;
+
+    /**
+     * Destructor - destroys the coroutine, wherever it is suspended.
+     */
+    ~Generator() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    /**
+     * Resumes the coroutine until it yields a value or returns. Rethrows any
+     * exception thrown by the coroutine.
+     *
+     * @return True if a value was yielded
+     *         False if the coroutine has finished
+     */
+    bool next() {
+        if (!handle || handle.done()) {
+            return false;
+        }
+        handle.resume();
+        if (handle.promise().error) {
+            std::rethrow_exception(handle.promise().error);
+        }
+        return !handle.done();
+    }
+
+    /**
+     * Returns the last value yielded. Valid until the next call to next.
+     *
+     * @return Last yielded value
+     */
+    const T &value() const {
+        return *handle.promise().current;
+    }
+
+    /**
+     * Resumes the coroutine to the first value and returns an iterator to it.
+     *
+     * @return Iterator to the first value, or end() if there is none
+     */
+    iterator begin() {
+        return next() ? iterator(this) : end();
+    }
+
+    /**
+     * Returns the end iterator.
+     *
+     * @return End iterator
+     */
+    iterator end() {
+        return iterator();
+    }
+
+private:
+    typedef std::coroutine_handle<promise_type> Handle;
+
+    Handle handle; // Coroutine producing the values
+
+    /**
+     * Constructor - wraps a coroutine handle.
+     *
+     * @param handle Coroutine handle
+     */
+    explicit Generator(Handle handle) : handle(handle) {}
+};
+
+#endif
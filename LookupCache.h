@@ -0,0 +1,310 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+
+/**
+ * Fixed-size membership cache which sits in front of a tree lookup. Each slot
+ * remembers whether a key was present the last time it was looked up, so
+ * repeated queries for hot keys are answered with a single probe. The cache
+ * is direct-mapped (one slot per hash bucket, newer keys evict older ones)
+ * and its slot array starts on a cache line boundary. The owning tree keeps
+ * it coherent by calling update() whenever a key is added or removed.
+ *
+ * @tparam  KeyType Data type of the key
+ * @author  Francis Kogge
+ * @version 1.0
+ * @date    12/09/2020
+ */
+template<typename KeyType>
+class LookupCache {
+
+public:
+    static const std::size_t CACHE_LINE = 64; // Alignment of the slot array
+
+    /**
+     * Constructor - creates a cache with the given number of slots. A cache
+     * with no slots is disabled.
+     *
+     * @param slots Number of slots (rounded up to a power of two)
+     */
+    explicit LookupCache(std::size_t slots = 0)
+            : raw(nullptr), table(nullptr), mask(0), shift(0), hits(0),
+              misses(0) {
+        resize(slots);
+    }
+
+    /**
+     * Copy constructor - creates an empty cache with the same number of slots
+     * as the other cache.
+     *
+     * @param other LookupCache object to copy the configuration of
+     */
+    LookupCache(const LookupCache<KeyType> &other)
+            : raw(nullptr), table(nullptr), mask(0), shift(0), hits(0),
+              misses(0) {
+        resize(other.slots());
+    }
+
+    /**
+     * Overloaded assignment operator - takes on the number of slots of the
+     * other cache and starts out empty.
+     *
+     * @param rhs LookupCache object to copy the configuration of
+     * @return    This LookupCache
+     */
+    LookupCache<KeyType> &operator=(const LookupCache<KeyType> &rhs) {
+        if (this != &rhs) {
+            resize(rhs.slots());
+        }
+        return *this;
+    }
+
+    /**
+     * Destructor - releases the slot array.
+     */
+    ~LookupCache() {
+        release();
+    }
+
+    /**
+     * Replaces the slot array with an empty one of the given size. Hit and
+     * miss counts are reset.
+     *
+     * @param slots Number of slots (rounded up to a power of two), or 0 to
+     *              disable the cache
+     */
+    void resize(std::size_t slots) {
+        release();
+        hits = misses = 0;
+        if (slots == 0) {
+            return;
+        }
+
+        // Round up to a power of two so a slot index is a multiply and shift
+        std::size_t capacity = 2;
+        int bits = 1;
+        while (capacity < slots) {
+            capacity <<= 1;
+            bits++;
+        }
+
+        // Over-allocate so the first slot can start on a cache line
+        raw = ::operator new(capacity * sizeof(Slot) + CACHE_LINE - 1);
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(raw);
+        address = (address + CACHE_LINE - 1) & ~std::uintptr_t(CACHE_LINE - 1);
+        table = reinterpret_cast<Slot*>(address);
+        for (std::size_t i = 0; i < capacity; i++) {
+            new (&table[i]) Slot();
+        }
+        mask = capacity - 1;
+        shift = 64 - bits;
+    }
+
+    /**
+     * Check if the cache has any slots.
+     *
+     * @return True if enabled
+     *         False if disabled
+     */
+    bool enabled() const {
+        return table != nullptr;
+    }
+
+    /**
+     * Returns the number of slots in the cache.
+     *
+     * @return Number of slots, 0 if disabled
+     */
+    std::size_t slots() const {
+        return enabled() ? mask + 1 : 0;
+    }
+
+    /**
+     * Looks up a key. Counts a hit or a miss if the cache is enabled.
+     *
+     * @param key     Key to look up
+     * @param present Set to whether the key is in the tree, on a hit
+     * @return        True if the cache knows about the key
+     *                False if the tree has to be searched
+     */
+    bool lookup(const KeyType &key, bool &present) {
+        if (!enabled()) {
+            return false;
+        }
+
+        const Slot &slot = table[indexOf(key)];
+        if (slot.valid && slot.key == key) {
+            hits++;
+            present = slot.present;
+            return true;
+        } else {
+            misses++;
+            return false;
+        }
+    }
+
+    /**
+     * Records the result of a tree search, evicting whatever key shared the
+     * slot.
+     *
+     * @param key     Key that was searched for
+     * @param present Whether the key was found
+     */
+    void store(const KeyType &key, bool present) {
+        if (enabled()) {
+            Slot &slot = table[indexOf(key)];
+            slot.key = key;
+            slot.valid = true;
+            slot.present = present;
+        }
+    }
+
+    /**
+     * Keeps the cache coherent after the tree changes. Only a slot already
+     * holding the key is touched, so adds and removes don't evict hot keys.
+     *
+     * @param key     Key that was added or removed
+     * @param present Whether the key is now in the tree
+     */
+    void update(const KeyType &key, bool present) {
+        if (enabled()) {
+            Slot &slot = table[indexOf(key)];
+            if (slot.valid && slot.key == key) {
+                slot.present = present;
+            }
+        }
+    }
+
+    /**
+     * Forgets every cached key, keeping the number of slots.
+     */
+    void invalidate() {
+        for (std::size_t i = 0; i < slots(); i++) {
+            table[i].valid = false;
+        }
+    }
+
+    /**
+     * Returns the number of lookups answered by the cache.
+     *
+     * @return Number of hits since the last resize or resetStats
+     */
+    long getHits() const {
+        return hits;
+    }
+
+    /**
+     * Returns the number of lookups that had to search the tree.
+     *
+     * @return Number of misses since the last resize or resetStats
+     */
+    long getMisses() const {
+        return misses;
+    }
+
+    /**
+     * Resets the hit and miss counts to zero.
+     */
+    void resetStats() {
+        hits = misses = 0;
+    }
+
+private:
+    /*
+     * Cached lookup result for a single key
+     */
+    struct Slot {
+        KeyType key;
+        bool valid;   // True if key holds a cached lookup
+        bool present; // True if key was in the tree
+
+        /**
+         * Slot constructor - creates an empty slot.
+         */
+        Slot() : key(), valid(false), present(false) {}
+    };
+
+    void *raw;          // Allocation holding the aligned slot array
+    Slot *table;        // First slot, on a cache line boundary
+    std::size_t mask;   // Number of slots minus one
+    int shift;          // 64 minus log2 of the number of slots
+    long hits, misses;  // Lookup statistics
+
+    /**
+     * Maps a key to its slot. The hash is scrambled with a multiplicative
+     * (Fibonacci) hash, since std::hash of an integer is usually the integer
+     * itself and strided keys would otherwise pile into the same slots.
+     *
+     * @param key Key to map
+     * @return    Index of the key's slot
+     */
+    std::size_t indexOf(const KeyType &key) const {
+        std::uint64_t hash = std::hash<KeyType>()(key);
+        return static_cast<std::size_t>(
+                (hash * 0x9E3779B97F4A7C15ull) >> shift) & mask;
+    }
+
+    /**
+     * Destroys the slots and frees the slot array.
+     */
+    void release() {
+        for (std::size_t i = 0; i < slots(); i++) {
+            table[i].~Slot();
+        }
+        ::operator delete(raw);
+        raw = nullptr;
+        table = nullptr;
+        mask = 0;
+        shift = 0;
+    }
+};
+
+/**
+ * Stand-in for LookupCache which caches nothing. It is the default cache of a
+ * BST, so that a tree without a cache doesn't need std::hash or == for its
+ * keys, and every call compiles to nothing.
+ *
+ * @tparam  KeyType Data type of the key
+ * @author  Francis Kogge
+ * @version 1.0
+ * @date    12/09/2020
+ */
+template<typename KeyType>
+class NoLookupCache {
+
+public:
+    /**
+     * Looks up a key, which is never cached.
+     *
+     * @param key     Key to look up
+     * @param present Left unchanged
+     * @return        False, the tree always has to be searched
+     */
+    bool lookup(const KeyType &/* key */, bool &/* present */) const {
+        return false;
+    }
+
+    /**
+     * Ignores the result of a tree search.
+     *
+     * @param key     Key that was searched for
+     * @param present Whether the key was found
+     */
+    void store(const KeyType &/* key */, bool /* present */) const {}
+
+    /**
+     * Ignores a change to the tree.
+     *
+     * @param key     Key that was added or removed
+     * @param present Whether the key is now in the tree
+     */
+    void update(const KeyType &/* key */, bool /* present */) const {}
+
+    /**
+     * Does nothing, there are no cached keys to forget.
+     */
+    void invalidate() const {}
+};
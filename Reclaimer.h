@@ -0,0 +1,97 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+/**
+ * Background thread which runs jobs that delete detached trees, so that
+ * destroying a large tree doesn't stall the thread that destroyed it. There
+ * is one reclaimer per program. Its thread starts with the first call to
+ * instance and is never stopped, so trees which are destroyed while the
+ * program exits (trees with static storage) can still hand their nodes to
+ * it; jobs still queued when the program ends are dropped, along with the
+ * rest of the program's memory.
+ *
+ * @author  Francis Kogge
+ * @version 1.0
+ * @date    12/09/2020
+ */
+class Reclaimer {
+
+public:
+    /**
+     * Returns the reclaimer, starting its thread on the first call.
+     *
+     * @return The program's reclaimer
+     */
+    static Reclaimer &instance() {
+        // Never deleted, see the class comment
+        static Reclaimer *reclaimer = new Reclaimer();
+        return *reclaimer;
+    }
+
+    Reclaimer(const Reclaimer &other) = delete;
+    Reclaimer &operator=(const Reclaimer &rhs) = delete;
+
+    /**
+     * Queues a job to run on the background thread. Jobs run one at a time,
+     * in the order they were submitted.
+     *
+     * @param job Job to run
+     */
+    void submit(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+        }
+        ready.notify_one();
+    }
+
+    /**
+     * Blocks until every job submitted so far has finished.
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this] { return jobs.empty() && !busy; });
+    }
+
+private:
+    std::mutex mutex;                        // Guards jobs and busy
+    std::condition_variable ready;           // Signalled when a job is queued
+    std::condition_variable idle;            // Signalled when jobs run out
+    std::deque<std::function<void()> > jobs; // Jobs waiting to run
+    bool busy;                               // True while a job is running
+
+    /**
+     * Constructor - starts the background thread.
+     */
+    Reclaimer() : busy(false) {
+        std::thread(&Reclaimer::run, this).detach();
+    }
+
+    /**
+     * Body of the background thread. Runs jobs as they are queued.
+     */
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            ready.wait(lock, [this] { return !jobs.empty(); });
+            std::function<void()> job = std::move(jobs.front());
+            jobs.pop_front();
+            busy = true;
+            // Run the job without holding the lock, so submit doesn't block
+            lock.unlock();
+            job();
+            job = nullptr;
+            lock.lock();
+            busy = false;
+            if (jobs.empty()) {
+                idle.notify_all();
+            }
+        }
+    }
+};
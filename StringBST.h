@@ -0,0 +1,446 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <sstream>
+
+/**
+ * Binary Search Tree of strings, laid out for fast comparisons. Each key is
+ * stored in the same allocation as its node (a node is one block of memory
+ * instead of a node plus a separate string buffer), and the first eight bytes
+ * of the key are cached in the node as an integer so that most comparisons
+ * are decided by a single integer compare.
+ *
+ * When prefix skipping is on, a search also keeps track of how many leading
+ * bytes the key is known to share with every node left in the subtree being
+ * searched, and comparisons start after those bytes. This pays off when
+ * neighbouring keys share long prefixes (paths, URLs, qualified names).
+ *
+ * @author  Francis Kogge
+ * @version 1.0
+ * @date    12/09/2020
+ */
+class StringBST {
+
+public:
+    /**
+     * Constructor - initializes root.
+     *
+     * @param skipPrefixes True to skip bytes already known to match while
+     *                     searching
+     */
+    explicit StringBST(bool skipPrefixes = true)
+            : root(nullptr), count(0), skipPrefixes(skipPrefixes) {};
+
+    /**
+     * Copy constructor - creates copy of the tree.
+     *
+     * @param other StringBST object to copy
+     */
+    StringBST(const StringBST &other)
+            : root(copy(other.root)), count(other.count),
+              skipPrefixes(other.skipPrefixes) {}
+
+    /**
+     * Overloaded assignment operator - destroys current tree and creates
+     * copy of the tree.
+     *
+     * @param rhs StringBST object to copy (on right hand side of operator).
+     * @return    This StringBST
+     */
+    StringBST &operator=(const StringBST &rhs) {
+        // If assignment is not to this instance
+        if (this != &rhs) {
+            clear(root);
+            root = copy(rhs.root);
+            count = rhs.count;
+            skipPrefixes = rhs.skipPrefixes;
+        }
+        return *this;
+    }
+
+    /**
+     * Destructor - calls helper method, clear.
+     */
+    ~StringBST() {
+        clear(root);
+    }
+
+    /**
+     * Insert a new element into the tree. If the element is already in the
+     * tree, this method does nothing.
+     *
+     * @param newKey Key to insert
+     */
+    void add(const std::string &newKey) {
+        Node **link = find(newKey);
+        if (*link == nullptr) {
+            *link = create(newKey.data(), newKey.size());
+            count++;
+        }
+    }
+
+    /**
+     * Check if the given key is present in the tree.
+     *
+     * @param key Key to check
+     * @return    True if it is present
+     *            False if it is not present
+     */
+    bool has(const std::string &key) const {
+        return *find(key) != nullptr;
+    }
+
+    /**
+     * Removes the given key from the tree.
+     *
+     * @param key Key to remove
+     */
+    void remove(const std::string &key) {
+        Node **link = find(key);
+        Node *current = *link;
+        // Key is not in the tree
+        if (current == nullptr) {
+            return;
+        }
+
+        if (current->left == nullptr) {
+            // Replace the current node with its right child
+            *link = current->right;
+        } else if (current->right == nullptr) {
+            // Replace the current node with its left child
+            *link = current->left;
+        } else {
+            // Keys can't be copied between nodes of different sizes, so the
+            // max node of the left subtree is moved into the current node's
+            // place instead
+            Node **maxLink = &current->left;
+            while ((*maxLink)->right != nullptr) {
+                maxLink = &(*maxLink)->right;
+            }
+            Node *max = *maxLink;
+            *maxLink = max->left;
+            max->left = current->left;
+            max->right = current->right;
+            *link = max;
+        }
+        destroy(current);
+        count--;
+    }
+
+    /**
+     * Check if this tree is empty.
+     *
+     * @return True if empty
+     *         False if not empty
+     */
+    bool empty() const {
+        return root == nullptr;
+    }
+
+    /**
+     * Returns the size the tree.
+     *
+     * @return Size of the tree
+     */
+    int size() const {
+        return count;
+    }
+
+    /**
+     * Returns the height of the tree.
+     *
+     * @return Height of the tree
+     */
+    int getHeight() const {
+        return getHeight(root);
+    }
+
+    /**
+     * Returns a string representing the in-order traversal.
+     *
+     * @return Key of each node, in-order
+     */
+    std::string getInOrderTraversal() const {
+        std::ostringstream ss;
+        getInOrderTraversal(root, ss);
+        return ss.str();
+    }
+
+    /**
+     * Returns a string representing the pre-order traversal.
+     *
+     * @return Key of each node, pre-order
+     */
+    std::string getPreOrderTraversal() const {
+        std::ostringstream ss;
+        getPreOrderTraversal(root, ss);
+        return ss.str();
+    }
+
+private:
+    static const std::size_t PREFIX_BYTES = sizeof(std::uint64_t);
+
+    /*
+     * Node objects which make up the binary search tree. The key's characters
+     * are stored directly after the node, in the same allocation.
+     */
+    struct Node {
+        std::uint64_t prefix; // First PREFIX_BYTES of the key, big-endian
+        Node *left, *right;   // Left and right child
+        std::size_t length;   // Length of the key
+
+        /**
+         * Returns the characters of the key.
+         *
+         * @return Key characters (not null terminated)
+         */
+        const char *chars() const {
+            return reinterpret_cast<const char*>(this + 1);
+        }
+    };
+
+    Node *root;        // Root of the tree
+    int count;         // Number of nodes in the tree
+    bool skipPrefixes; // True if searches skip bytes known to match
+
+    /**
+     * Packs the first PREFIX_BYTES of a key into an integer, most significant
+     * byte first and zero padded, so comparing two packed prefixes orders
+     * them the same way as comparing the bytes.
+     *
+     * @param chars  Key characters
+     * @param length Length of the key
+     * @return       Packed prefix
+     */
+    static std::uint64_t packPrefix(const char *chars, std::size_t length) {
+        std::uint64_t prefix = 0;
+        for (std::size_t i = 0; i < PREFIX_BYTES; i++) {
+            prefix <<= 8;
+            if (i < length) {
+                prefix |= static_cast<unsigned char>(chars[i]);
+            }
+        }
+        return prefix;
+    }
+
+    /**
+     * Compares a key against a node's key, starting at the given byte. Both
+     * keys must be known to agree on every byte before start.
+     *
+     * @param key    Key to compare
+     * @param prefix Packed prefix of key
+     * @param node   Node to compare against
+     * @param start  Number of leading bytes known to match
+     * @param common Set to the length of the common prefix of the two keys
+     * @return       Negative if key is less, 0 if equal, positive if greater
+     */
+    static int compare(const std::string &key, std::uint64_t prefix,
+                       const Node *node, std::size_t start,
+                       std::size_t &common) {
+        std::size_t shorter = std::min<std::size_t>(key.size(), node->length);
+
+        if (start < PREFIX_BYTES) {
+            std::uint64_t difference = prefix ^ node->prefix;
+            if (difference != 0) {
+                // The first differing byte of the packed prefixes is the
+                // first differing byte of the keys (or one key's end)
+                common = 0;
+                while ((difference >> 56) == 0) {
+                    difference <<= 8;
+                    common++;
+                }
+                common = std::min(common, shorter);
+                return prefix < node->prefix ? -1 : 1;
+            }
+            // Packed prefixes match, so the keys agree up to here
+            start = shorter < PREFIX_BYTES ? shorter : PREFIX_BYTES;
+        }
+
+        const unsigned char *a =
+                reinterpret_cast<const unsigned char*>(key.data());
+        const unsigned char *b =
+                reinterpret_cast<const unsigned char*>(node->chars());
+        std::size_t i = start;
+        while (i < shorter && a[i] == b[i]) {
+            i++;
+        }
+        common = i;
+        if (i < shorter) {
+            return a[i] < b[i] ? -1 : 1;
+        } else if (key.size() == node->length) {
+            return 0;
+        } else {
+            return key.size() < node->length ? -1 : 1;
+        }
+    }
+
+    /**
+     * Searches for a key, returning the link that points to its node, or the
+     * null link where it would be added.
+     *
+     * @param key Key to search for
+     * @return    Link to the key's node, or to null if not found
+     */
+    Node **find(const std::string &key) {
+        return search(&root, key, skipPrefixes);
+    }
+
+    /**
+     * Searches for a key, returning the link that points to its node, or the
+     * null link where it would be.
+     *
+     * @param key Key to search for
+     * @return    Link to the key's node, or to null if not found
+     */
+    Node *const *find(const std::string &key) const {
+        return search(&root, key, skipPrefixes);
+    }
+
+    /**
+     * Helper method for find, shared by its const and non-const versions.
+     * With prefix skipping, the search remembers the common prefix length of
+     * the key with the closest smaller and closest greater node passed so
+     * far. Every node below lies between those two, so it shares at least the
+     * smaller of the two lengths with the key and those bytes need not be
+     * compared again.
+     *
+     * @tparam Link        Node** or Node *const*
+     * @param link         Link to the root of the tree
+     * @param key          Key to search for
+     * @param skipPrefixes True to skip bytes known to match
+     * @return             Link to the key's node, or to null if not found
+     */
+    template<typename Link>
+    static Link search(Link link, const std::string &key, bool skipPrefixes) {
+        std::uint64_t prefix = packPrefix(key.data(), key.size());
+        std::size_t lowCommon = 0, highCommon = 0, common;
+
+        while (*link != nullptr) {
+            std::size_t start = skipPrefixes ?
+                                std::min(lowCommon, highCommon) : 0;
+            int result = compare(key, prefix, *link, start, common);
+            if (result < 0) {
+                // Current node is greater than the key
+                highCommon = common;
+                link = &(*link)->left;
+            } else if (result > 0) {
+                // Current node is less than the key
+                lowCommon = common;
+                link = &(*link)->right;
+            } else {
+                break;
+            }
+        }
+        return link;
+    }
+
+    /**
+     * Allocates a node with the key stored after it.
+     *
+     * @param chars  Key characters
+     * @param length Length of the key
+     * @return       New leaf node
+     */
+    static Node *create(const char *chars, std::size_t length) {
+        Node *node = new (::operator new(sizeof(Node) + length)) Node;
+        node->prefix = packPrefix(chars, length);
+        node->left = node->right = nullptr;
+        node->length = length;
+        std::memcpy(node + 1, chars, length);
+        return node;
+    }
+
+    /**
+     * Frees a node allocated by create.
+     *
+     * @param node Node to free
+     */
+    static void destroy(Node *node) {
+        ::operator delete(node);
+    }
+
+    /**
+     * Recursive helper method for getHeight.
+     *
+     * @param current Subtree to find height of
+     * @return        Height of the tree
+     */
+    static int getHeight(const Node *current) {
+        if (current == nullptr) {
+            return 0;
+        } else {
+            return 1 + std::max(getHeight(current->left),
+                                getHeight(current->right));
+        }
+    }
+
+    /**
+     * Recursive helper method for getInOrderTraversal.
+     *
+     * @param current Subtree to traverse, in-order
+     * @param ss      Output string stream
+     */
+    static void getInOrderTraversal(const Node *current,
+                                    std::ostringstream &ss) {
+        if (current == nullptr) {
+            return;
+        }
+
+        getInOrderTraversal(current->left, ss);
+        ss.write(current->chars(), current->length);
+        ss << " ";
+        getInOrderTraversal(current->right, ss);
+    }
+
+    /**
+     * Recursive helper method for getPreOrderTraversal.
+     *
+     * @param current Subtree to traverse, pre-order
+     * @param ss      Output string stream
+     */
+    static void getPreOrderTraversal(const Node *current,
+                                     std::ostringstream &ss) {
+        if (current == nullptr) {
+            return;
+        }
+
+        ss.write(current->chars(), current->length);
+        ss << " ";
+        getPreOrderTraversal(current->left, ss);
+        getPreOrderTraversal(current->right, ss);
+    }
+
+    /**
+     * Recursive helper method to copy a subtree.
+     *
+     * @param current Root of the subtree to copy
+     * @return        Copy of the subtree
+     */
+    static Node *copy(const Node *current) {
+        if (current == nullptr) {
+            return nullptr;
+        } else {
+            Node *node = create(current->chars(), current->length);
+            node->left = copy(current->left);
+            node->right = copy(current->right);
+            return node;
+        }
+    }
+
+    /**
+     * Recursive helper method to delete a subtree.
+     *
+     * @param current Root of the subtree to delete
+     */
+    static void clear(Node *current) {
+        if (current != nullptr) {
+            clear(current->left);
+            clear(current->right);
+            destroy(current);
+        }
+    }
+};
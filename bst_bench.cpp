@@ -0,0 +1,688 @@
+/**
+ * This program benchmarks the Binary Search Tree (BST) implementation class.
+ * Trees are built from randomly shuffled keys so they stay reasonably
+ * balanced, and each benchmark reports the average time per operation.
+ *
+ * Usage: BinarySearchTreeBench [number of keys] [number of queries]
+ *                              [number of strings]
+ *
+ * @author  Francis Kogge
+ * @version 1.0
+ * @date    12/09/2020
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "BST.h"
+#include "CompactBST.h"
+#include "StringBST.h"
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+/*
+ * Heap usage counters, kept up to date by the operator new and delete
+ * replacements below so benchmarks can measure how much memory a tree takes.
+ * Counts are of requested bytes, so they leave out malloc's own per-block
+ * overhead (typically 8 to 16 bytes per allocation). They are atomic since
+ * the background Reclaimer frees nodes on its own thread.
+ */
+static const size_t HEAP_HEADER = 16; // Keeps returned blocks 16-byte aligned
+static atomic<size_t> heapBytes(0);   // Live bytes requested
+static atomic<size_t> heapBlocks(0);  // Live allocations
+
+/**
+ * Replacement operator new which records the size of each allocation in a
+ * header in front of the block.
+ *
+ * @param size Number of bytes requested
+ * @return     Allocated block
+ */
+void *operator new(size_t size) {
+    char *block = static_cast<char*>(malloc(size + HEAP_HEADER));
+    if (block == nullptr) {
+        throw bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    heapBytes += size;
+    heapBlocks++;
+    return block + HEAP_HEADER;
+}
+
+/**
+ * Replacement operator delete matching the operator new above.
+ *
+ * @param pointer Block to free
+ */
+void operator delete(void *pointer) noexcept {
+    if (pointer != nullptr) {
+        char *block = static_cast<char*>(pointer) - HEAP_HEADER;
+        heapBytes -= *reinterpret_cast<size_t*>(block);
+        heapBlocks--;
+        free(block);
+    }
+}
+
+/**
+ * Sized operator delete, forwarded to the unsized one.
+ *
+ * @param pointer Block to free
+ */
+void operator delete(void *pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+/**
+ * Returns the nanoseconds elapsed since the given start time.
+ *
+ * @param start Start time
+ * @return      Elapsed nanoseconds
+ */
+double elapsedNs(Clock::time_point start) {
+    return chrono::duration<double, nano>(Clock::now() - start).count();
+}
+
+/**
+ * Displays title indicating which benchmark is running.
+ *
+ * @param name Benchmark name
+ */
+void displayBenchTitle(const string &name) {
+    cout << endl << "** " << name << " **" << endl;
+}
+
+/**
+ * Creates the keys 0 to n - 1 in random order.
+ *
+ * @param n   Number of keys
+ * @param rng Random number generator
+ * @return    Shuffled keys
+ */
+vector<int> shuffledKeys(int n, mt19937 &rng) {
+    vector<int> keys(n);
+    for (int i = 0; i < n; i++) {
+        keys[i] = i;
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+    return keys;
+}
+
+/**
+ * Creates a stream of queries drawn uniformly from the given keys.
+ *
+ * @tparam Key  Type of key
+ * @param keys  Keys to draw from
+ * @param count Number of queries
+ * @param rng   Random number generator
+ * @return      Query stream
+ */
+template<typename Key>
+vector<Key> uniformStream(const vector<Key> &keys, int count, mt19937 &rng) {
+    uniform_int_distribution<int> pick(0, (int) keys.size() - 1);
+    vector<Key> stream(count);
+    for (int i = 0; i < count; i++) {
+        stream[i] = keys[pick(rng)];
+    }
+    return stream;
+}
+
+/**
+ * Creates a stream of queries drawn from the given keys with a Zipfian
+ * distribution, where the key of rank r is picked with probability
+ * proportional to 1 / r^skew. Ranks are assigned in the (shuffled) order of
+ * the keys, so hot keys are scattered throughout the tree.
+ *
+ * @param keys  Keys to draw from
+ * @param count Number of queries
+ * @param skew  Zipf exponent
+ * @param rng   Random number generator
+ * @return      Query stream
+ */
+vector<int> zipfStream(const vector<int> &keys, int count, double skew,
+                       mt19937 &rng) {
+    // Cumulative distribution over the ranks
+    vector<double> cdf(keys.size());
+    double sum = 0;
+    for (size_t rank = 0; rank < keys.size(); rank++) {
+        sum += 1.0 / pow(rank + 1.0, skew);
+        cdf[rank] = sum;
+    }
+
+    uniform_real_distribution<double> pick(0, sum);
+    vector<int> stream(count);
+    for (int i = 0; i < count; i++) {
+        size_t rank = lower_bound(cdf.begin(), cdf.end(), pick(rng)) -
+                      cdf.begin();
+        stream[i] = keys[min(rank, keys.size() - 1)];
+    }
+    return stream;
+}
+
+/**
+ * Creates n distinct URL-like strings in random order. Like real paths they
+ * share long prefixes: every string starts with the same host, and strings
+ * in the same section and category share the next component or two.
+ *
+ * @param n   Number of strings
+ * @param rng Random number generator
+ * @return    Shuffled strings
+ */
+vector<string> urlKeys(int n, mt19937 &rng) {
+    static const char *sections[] = {"products", "support", "blog", "docs",
+                                     "community", "careers", "press", "store"};
+    static const char *categories[] = {"hardware", "software", "accessories",
+                                       "networking", "storage", "displays",
+                                       "audio", "mobile", "gaming", "office"};
+    vector<string> keys(n);
+    for (int i = 0; i < n; i++) {
+        // Spread the ids so that neighbouring strings differ in the middle
+        ostringstream ss;
+        ss << "https://www.example.com/" << sections[i % 8] << "/"
+           << categories[(i / 8) % 10] << "/item-" << (i / 80) * 7919 % 1000003
+           << "-" << i / 80;
+        keys[i] = ss.str();
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+    return keys;
+}
+
+/**
+ * Times has over a query stream.
+ *
+ * @tparam Tree  Type of tree to query
+ * @tparam Key   Type of key
+ * @param tree   Tree to query
+ * @param stream Query stream
+ * @param found  Set to the number of keys found
+ * @return       Average nanoseconds per query
+ */
+template<typename Tree, typename Key>
+double nsPerHas(const Tree &tree, const vector<Key> &stream, long &found) {
+    found = 0;
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < stream.size(); i++) {
+        found += tree.has(stream[i]);
+    }
+    return elapsedNs(start) / stream.size();
+}
+
+/**
+ * Prints the label and time of a benchmark run.
+ *
+ * @param label Description of the run
+ * @param ns    Average nanoseconds per operation
+ * @param unit  Name of the operation
+ */
+void printTime(const string &label, double ns, const string &unit) {
+    cout << left << setw(28) << label << right << fixed << setprecision(1)
+         << setw(10) << ns << " ns/" << unit;
+}
+
+/**
+ * Prints the hit rate of a tree without a lookup cache, which is nothing.
+ *
+ * @param bst BST object
+ */
+void printHitRate(const BST<int> &/* bst */) {}
+
+/**
+ * Prints the hit rate of a tree's lookup cache.
+ *
+ * @param bst BST object
+ */
+void printHitRate(const BST<int, LookupCache<int> > &bst) {
+    long lookups = bst.getCacheHits() + bst.getCacheMisses();
+    if (lookups > 0) {
+        cout << "   hit rate " << setw(5)
+             << 100.0 * bst.getCacheHits() / lookups << "%";
+    }
+}
+
+/**
+ * Times has over a query stream and prints the result.
+ *
+ * @tparam Tree  Type of BST to query
+ * @param label  Description of the run
+ * @param bst    BST object to query
+ * @param stream Query stream
+ */
+template<typename Tree>
+void timeHas(const string &label, const Tree &bst,
+             const vector<int> &stream) {
+    long found;
+    printTime(label, nsPerHas(bst, stream, found), "query");
+    printHitRate(bst);
+    // Print the found count so the loop can't be optimized away
+    cout << "   (found " << found << ")" << endl;
+}
+
+/**
+ * Benchmarks has with the lookup cache disabled and enabled, on uniform and
+ * Zipfian query streams.
+ *
+ * @param numKeys    Number of keys in the tree
+ * @param numQueries Number of queries per stream
+ */
+void benchCache(int numKeys, int numQueries) {
+    displayBenchTitle("LOOKUP CACHE");
+    mt19937 rng(42);
+    vector<int> keys = shuffledKeys(numKeys, rng);
+    BST<int> bst;
+    for (size_t i = 0; i < keys.size(); i++) {
+        bst.add(keys[i]);
+    }
+
+    vector<int> uniform = uniformStream(keys, numQueries, rng);
+    vector<int> zipf = zipfStream(keys, numQueries, 0.99, rng);
+
+    timeHas("uniform, no cache", bst, uniform);
+    timeHas("zipf 0.99, no cache", bst, zipf);
+    // The cached tree shares the plain tree's nodes
+    BST<int, LookupCache<int> > cached(bst);
+    cached.enableCache(65536);
+    timeHas("uniform, 65536-slot cache", cached, uniform);
+    cached.enableCache(65536);
+    timeHas("zipf 0.99, 65536-slot cache", cached, zipf);
+}
+
+/**
+ * Builds a tree from the given keys, measuring the heap it takes.
+ *
+ * @tparam Tree Type of tree to build
+ * @tparam Key  Type of key
+ * @param tree  Empty tree to add the keys to
+ * @param keys  Keys to add
+ * @param label Description of the tree, for the printed result
+ */
+template<typename Tree, typename Key>
+void buildAndMeasure(Tree &tree, const vector<Key> &keys,
+                     const string &label) {
+    size_t bytesBefore = heapBytes, blocksBefore = heapBlocks;
+    for (size_t i = 0; i < keys.size(); i++) {
+        tree.add(keys[i]);
+    }
+    cout << left << setw(28) << label << right << fixed << setprecision(1)
+         << setw(10) << double(heapBytes - bytesBefore) / keys.size()
+         << " bytes/key " << setw(6)
+         << double(heapBlocks - blocksBefore) / keys.size()
+         << " allocations/key" << endl;
+}
+
+/**
+ * Reference tree which copies every node when it is copied, the way BST did
+ * before its copies shared nodes. Only what the copy and pipeline benchmarks
+ * use is defined.
+ *
+ * @tparam KeyType Data type of the key
+ */
+template<typename KeyType>
+class DeepCopyBST {
+
+public:
+    DeepCopyBST() : root(nullptr), count(0) {}
+
+    DeepCopyBST(const DeepCopyBST &other)
+            : root(copy(other.root)), count(other.count) {}
+
+    DeepCopyBST &operator=(const DeepCopyBST &rhs) {
+        if (this != &rhs) {
+            clear(root);
+            root = copy(rhs.root);
+            count = rhs.count;
+        }
+        return *this;
+    }
+
+    ~DeepCopyBST() {
+        clear(root);
+    }
+
+    void add(const KeyType &newKey) {
+        Node **link = find(newKey);
+        if (*link == nullptr) {
+            *link = new Node(newKey);
+            count++;
+        }
+    }
+
+    void remove(const KeyType &key) {
+        Node **link = find(key);
+        Node *current = *link;
+        if (current == nullptr) {
+            return;
+        }
+        if (current->left == nullptr || current->right == nullptr) {
+            *link = current->left != nullptr ? current->left : current->right;
+            delete current;
+        } else {
+            Node **maxLink = &current->left;
+            while ((*maxLink)->right != nullptr) {
+                maxLink = &(*maxLink)->right;
+            }
+            Node *max = *maxLink;
+            current->key = max->key;
+            *maxLink = max->left;
+            delete max;
+        }
+        count--;
+    }
+
+    int size() const {
+        return count;
+    }
+
+private:
+    struct Node {
+        KeyType key;
+        Node *left, *right;
+
+        explicit Node(const KeyType &key)
+                : key(key), left(nullptr), right(nullptr) {}
+    };
+
+    Node *root;
+    int count;
+
+    Node **find(const KeyType &key) {
+        Node **link = &root;
+        while (*link != nullptr && ((*link)->key < key || key < (*link)->key)) {
+            link = key < (*link)->key ? &(*link)->left : &(*link)->right;
+        }
+        return link;
+    }
+
+    static Node *copy(const Node *current) {
+        if (current == nullptr) {
+            return nullptr;
+        }
+        Node *node = new Node(current->key);
+        node->left = copy(current->left);
+        node->right = copy(current->right);
+        return node;
+    }
+
+    static void clear(Node *current) {
+        if (current != nullptr) {
+            clear(current->left);
+            clear(current->right);
+            delete current;
+        }
+    }
+};
+
+/**
+ * Times copying a tree and prints the result.
+ *
+ * @tparam Tree Type of tree to copy
+ * @param tree  Tree to copy
+ * @param label Description of the run
+ */
+template<typename Tree>
+void timeCopy(const Tree &tree, const string &label) {
+    Clock::time_point start = Clock::now();
+    Tree copy(tree);
+    printTime(label, elapsedNs(start) / copy.size(), "key");
+    cout << endl;
+}
+
+/**
+ * Benchmarks the pointer-based BST against CompactBST for memory, lookup
+ * throughput and copy time. BST copies share nodes and take the same time
+ * whatever the size of the tree, so copying is compared against the
+ * node-by-node copy BST used to make (DeepCopyBST) instead.
+ *
+ * @param numKeys    Number of keys in the trees
+ * @param numQueries Number of queries
+ */
+void benchCompact(int numKeys, int numQueries) {
+    displayBenchTitle("COMPACT NODES");
+    mt19937 rng(42);
+    vector<int> keys = shuffledKeys(numKeys, rng);
+    vector<int> stream = uniformStream(keys, numQueries, rng);
+    long found;
+
+    BST<int> bst;
+    CompactBST<int> compact;
+    DeepCopyBST<int> deep;
+    buildAndMeasure(bst, keys, "BST<int>");
+    buildAndMeasure(compact, keys, "CompactBST<int>");
+    for (size_t i = 0; i < keys.size(); i++) {
+        deep.add(keys[i]);
+    }
+
+    double ns = nsPerHas(bst, stream, found);
+    printTime("BST<int> has", ns, "query");
+    cout << "  " << setprecision(2) << 1000 / ns << " M queries/s" << endl;
+    ns = nsPerHas(compact, stream, found);
+    printTime("CompactBST<int> has", ns, "query");
+    cout << "  " << setprecision(2) << 1000 / ns << " M queries/s" << endl;
+
+    timeCopy(deep, "DeepCopyBST<int> copy");
+    timeCopy(compact, "CompactBST<int> copy");
+}
+
+/**
+ * Pipeline stage which takes a tree by value, changes a few keys and passes
+ * the tree on, keeping the input unchanged for whoever else holds it.
+ *
+ * @tparam Tree     Type of tree
+ * @param tree      Input tree (a copy)
+ * @param firstKey  First key to remove; the same number of keys above the
+ *                  tree's largest key are added
+ * @param numEdits  Number of keys to remove and to add
+ * @param keyOffset Distance between a removed key and the key added for it
+ * @return          Output tree
+ */
+template<typename Tree>
+Tree pipelineStage(Tree tree, int firstKey, int numEdits, int keyOffset) {
+    for (int key = firstKey; key < firstKey + numEdits; key++) {
+        tree.remove(key);
+        tree.add(key + keyOffset);
+    }
+    return tree;
+}
+
+/**
+ * Runs a pipeline of stages which pass a tree by value, keeping every
+ * stage's output alive, and prints the time and extra heap per stage.
+ *
+ * @tparam Tree     Type of tree
+ * @param tree      Input of the first stage
+ * @param numStages Number of stages
+ * @param numEdits  Number of keys removed and added by each stage
+ * @param label     Description of the tree, for the printed result
+ */
+template<typename Tree>
+void timePipeline(const Tree &tree, int numStages, int numEdits,
+                  const string &label) {
+    vector<Tree> outputs;
+    outputs.reserve(numStages + 1);
+    outputs.push_back(tree);
+
+    int keyOffset = tree.size();
+    size_t bytesBefore = heapBytes;
+    Clock::time_point start = Clock::now();
+    for (int stage = 0; stage < numStages; stage++) {
+        outputs.push_back(pipelineStage(outputs.back(), stage * numEdits,
+                                        numEdits, keyOffset));
+    }
+    printTime(label, elapsedNs(start) / numStages, "stage");
+    cout << setw(12) << setprecision(0)
+         << double(heapBytes - bytesBefore) / numStages << " bytes/stage"
+         << endl;
+}
+
+/**
+ * Benchmarks a pipeline of stages which each take a tree by value and change
+ * a few keys. BST copies share nodes, so a stage pays only for the nodes it
+ * changes; DeepCopyBST copies every node, as BST used to, and CompactBST
+ * copies its whole node vector.
+ *
+ * @param numKeys Number of keys in the tree
+ */
+void benchPipeline(int numKeys) {
+    displayBenchTitle("PASS-BY-VALUE PIPELINE (16 stages, 10 edits each)");
+    mt19937 rng(42);
+    vector<int> keys = shuffledKeys(numKeys, rng);
+    BST<int> bst;
+    DeepCopyBST<int> deep;
+    CompactBST<int> compact;
+    for (size_t i = 0; i < keys.size(); i++) {
+        bst.add(keys[i]);
+        deep.add(keys[i]);
+        compact.add(keys[i]);
+    }
+
+    timePipeline(bst, 16, 10, "BST<int> (shared copies)");
+    timePipeline(deep, 16, 10, "DeepCopyBST<int>");
+    timePipeline(compact, 16, 10, "CompactBST<int>");
+}
+
+/**
+ * Builds a BST from the given keys.
+ *
+ * @param bst  Empty BST object to add the keys to
+ * @param keys Keys to add
+ */
+void buildTree(BST<int> &bst, const vector<int> &keys) {
+    for (size_t i = 0; i < keys.size(); i++) {
+        bst.add(keys[i]);
+    }
+}
+
+/**
+ * Benchmarks clearing a large tree immediately against clearing it with
+ * deferred destruction, where later writes each delete a few nodes, and
+ * destroying a tree immediately against handing it to the background
+ * Reclaimer.
+ *
+ * @param numKeys Number of keys in the tree
+ */
+void benchClear(int numKeys) {
+    displayBenchTitle("CLEAR");
+    const int nodesPerWrite = 64, numWrites = 5000;
+    mt19937 rng(42);
+    vector<int> keys = shuffledKeys(numKeys, rng);
+
+    BST<int> immediate;
+    buildTree(immediate, keys);
+    Clock::time_point start = Clock::now();
+    immediate.clear();
+    printTime("immediate clear", elapsedNs(start), "clear");
+    cout << endl;
+
+    BST<int> deferred;
+    buildTree(deferred, keys);
+    deferred.setDeferredDestruction(nodesPerWrite);
+    start = Clock::now();
+    deferred.clear();
+    printTime("deferred clear", elapsedNs(start), "clear");
+    cout << endl;
+
+    // Writes after the clear, each deleting up to nodesPerWrite nodes
+    double worst = 0, total = 0;
+    for (int i = 0; i < numWrites; i++) {
+        start = Clock::now();
+        deferred.add(keys[i % keys.size()]);
+        double ns = elapsedNs(start);
+        worst = max(worst, ns);
+        total += ns;
+    }
+    printTime("add while reclaiming", total / numWrites, "add");
+    cout << "   worst " << setprecision(0) << worst << " ns" << endl;
+
+    start = Clock::now();
+    size_t deleted = deferred.reclaim(numKeys);
+    printTime("reclaim(rest)", elapsedNs(start), "call");
+    cout << "   (deleted the " << deleted << " nodes left after "
+         << numWrites << " adds)" << endl;
+
+    {
+        BST<int> doomed;
+        buildTree(doomed, keys);
+        start = Clock::now();
+    }
+    printTime("immediate destructor", elapsedNs(start), "tree");
+    cout << endl;
+
+    {
+        BST<int> doomed;
+        buildTree(doomed, keys);
+        doomed.setDeferredDestruction(nodesPerWrite);
+        start = Clock::now();
+    }
+    printTime("deferred destructor", elapsedNs(start), "tree");
+    cout << endl;
+    // Let the reclaimer finish before anything else is measured
+    start = Clock::now();
+    Reclaimer::instance().wait();
+    printTime("wait for reclaimer", elapsedNs(start), "tree");
+    cout << endl;
+}
+
+/**
+ * Benchmarks BST<string> against StringBST for memory and lookup time on
+ * URL-like strings.
+ *
+ * @param numStrings Number of strings in the trees
+ * @param numQueries Number of queries
+ */
+void benchStrings(int numStrings, int numQueries) {
+    displayBenchTitle("STRING KEYS");
+    mt19937 rng(42);
+    vector<string> keys = urlKeys(numStrings, rng);
+    vector<string> stream = uniformStream(keys, numQueries, rng);
+    long found;
+
+    BST<string> bst;
+    StringBST noSkip(false), skip(true);
+    buildAndMeasure(bst, keys, "BST<string>");
+    buildAndMeasure(skip, keys, "StringBST");
+    for (size_t i = 0; i < keys.size(); i++) {
+        noSkip.add(keys[i]);
+    }
+
+    printTime("BST<string> has", nsPerHas(bst, stream, found), "query");
+    cout << endl;
+    printTime("StringBST has, no skipping", nsPerHas(noSkip, stream, found),
+              "query");
+    cout << endl;
+    printTime("StringBST has, skipping", nsPerHas(skip, stream, found),
+              "query");
+    cout << endl;
+}
+
+/**
+ * Runs the benchmarks.
+ *
+ * @param argc Number of command line arguments
+ * @param argv Number of keys, number of queries and number of strings (all
+ *             optional)
+ * @return 0   Indicates successful program.
+ */
+int main(int argc, char *argv[]) {
+    int numKeys = argc > 1 ? atoi(argv[1]) : 1000000;
+    int numQueries = argc > 2 ? atoi(argv[2]) : 2000000;
+    int numStrings = argc > 3 ? atoi(argv[3]) : 1000000;
+    cout << "Keys: " << numKeys << ", queries: " << numQueries
+         << ", strings: " << numStrings << endl;
+
+    benchCache(numKeys, numQueries);
+    benchCompact(numKeys, numQueries);
+    benchStrings(numStrings, numQueries);
+    benchPipeline(numKeys);
+    benchClear(numKeys);
+
+    return 0;
+}
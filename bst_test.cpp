@@ -10,8 +10,14 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
+#include <vector>
 #include "BST.h"
+#include "BSTMap.h"
+#include "BSTMultiset.h"
+#include "CompactBST.h"
+#include "StringBST.h"
 
 using namespace std;
 
@@ -119,6 +125,38 @@ void testHas(const BST<T> &bst, const T *array, int size) {
     }
 }
 
+/**
+ * Tests the lookup cache of a BSTx object. Every key is looked up twice on a
+ * copy of the tree with the cache enabled, so the second round should be
+ * answered entirely by the cache. The first key is then removed and added
+ * back to check that the cache stays coherent.
+ *
+ * @tparam T       Data type of the BSTx object and array elements
+ * @param bst      BSTx object
+ * @param array    Array holding data to look up
+ * @param size     Size of the array
+ */
+template<typename T>
+void testCache(const BST<T> &bst, const T *array, int size) {
+    BST<T, LookupCache<T> > cached(bst);
+    displayTestTitle("TEST CACHE");
+    cached.enableCache();
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < size; i++) {
+            cached.has(array[i]);
+        }
+    }
+    cout << "Cache hits:     " << cached.getCacheHits() << endl;
+    cout << "Cache misses:   " << cached.getCacheMisses() << endl;
+
+    cached.remove(array[0]);
+    cout << "has(" << array[0] << ") after remove: "
+         << (cached.has(array[0]) ? "True" : "False") << endl;
+    cached.add(array[0]);
+    cout << "has(" << array[0] << ") after add:    "
+         << (cached.has(array[0]) ? "True" : "False") << endl;
+}
+
 /**
  * Adds initial data to a BSTx object of type string.
  *
@@ -184,6 +222,425 @@ bool addPrimitiveTree(BST<T> &bst, const string &dataFile) {
     }
 }
 
+/**
+ * Tests that copies of a BSTx object, which share nodes until written to,
+ * are isolated from each other. A copy has the array removed from it and
+ * another copy is assigned from it and has the array added back, checking
+ * after each step that the trees it was copied from did not change.
+ *
+ * @tparam T    Data type of the BSTx object and array elements
+ * @param bst   BSTx object
+ * @param array Array holding data to remove and add
+ * @param size  Size of the array
+ */
+template<typename T>
+void testCopyOnWrite(const BST<T> &bst, const T *array, int size) {
+    string original = bst.getPreOrderTraversal();
+    BST<T> copy(bst);
+    for (int i = 0; i < size; i++) {
+        copy.remove(array[i]);
+    }
+    string removed = copy.getPreOrderTraversal();
+
+    BST<T> assigned;
+    assigned = copy;
+    for (int i = 0; i < size; i++) {
+        assigned.add(array[i]);
+    }
+
+    displayTestTitle("TEST COPY ON WRITE");
+    cout << "Copy:           " << copy.getInOrderTraversal() << endl;
+    cout << "Assigned:       " << assigned.getInOrderTraversal() << endl;
+    cout << "Original kept:  "
+         << (bst.getPreOrderTraversal() == original ? "True" : "False")
+         << endl;
+    cout << "Copy kept:      "
+         << (copy.getPreOrderTraversal() == removed ? "True" : "False")
+         << endl;
+}
+
+/**
+ * Tests the in-order cursor of a BSTx object. A copy of the tree is exported
+ * three keys at a time, and after the first chunk the array is removed from
+ * the copy; the cursor should carry on with the tree as it was when the
+ * cursor was created. With coroutine support the chunked generator is
+ * tested too.
+ *
+ * @tparam T    Data type of the BSTx object and array elements
+ * @param bst   BSTx object
+ * @param array Array holding data to remove while the cursor is in use
+ * @param size  Size of the array
+ */
+template<typename T>
+void testCursor(const BST<T> &bst, const T *array, int size) {
+    displayTestTitle("TEST CURSOR");
+    BST<T> tree(bst);
+    typename BST<T>::Cursor cursor = tree.getInOrderCursor();
+    ostringstream exported;
+    vector<T> chunk;
+
+    cout << "Chunks:         ";
+    while (cursor.nextChunk(chunk, 3) > 0) {
+        cout << "[ ";
+        for (size_t i = 0; i < chunk.size(); i++) {
+            cout << chunk[i] << " ";
+            exported << chunk[i] << " ";
+        }
+        cout << "] ";
+        // Change the tree half way through the export
+        for (int i = 0; i < size; i++) {
+            tree.remove(array[i]);
+        }
+    }
+    cout << endl;
+    cout << "Matches BST:    "
+         << (exported.str() == bst.getInOrderTraversal() ? "True" : "False")
+         << endl;
+
+    ostringstream written;
+    typename BST<T>::Cursor writer = bst.getInOrderCursor();
+    while (writer.writeChunk(written, 4) > 0) {
+        written << "| ";
+    }
+    cout << "Written:        " << written.str() << endl;
+
+#ifdef BST_HAS_COROUTINES
+    ostringstream generated;
+    for (const vector<T> &keys : bst.getInOrderChunks(3)) {
+        for (size_t i = 0; i < keys.size(); i++) {
+            generated << keys[i] << " ";
+        }
+    }
+    cout << "Generator:      "
+         << (generated.str() == bst.getInOrderTraversal() ? "True" : "False")
+         << endl;
+#endif
+}
+
+/**
+ * Tests deferred destruction of a BSTx object. A tree with the same keys is
+ * cleared with deferred destruction on (one node per write), then half of
+ * the array is added, which should delete one detached node per add, and
+ * reclaim deletes the rest. Last, a changed copy of the tree and a cursor
+ * over the copy are destroyed, which hands their nodes to the background
+ * Reclaimer, and the tree should be left as it was.
+ *
+ * @tparam T    Data type of the BSTx object and array elements
+ * @param bst   BSTx object
+ * @param array Array holding data to add after clearing
+ * @param size  Size of the array
+ */
+template<typename T>
+void testDeferredClear(const BST<T> &bst, const T *array, int size) {
+    // Rebuild rather than copy, so the nodes aren't shared with bst
+    BST<T> tree;
+    istringstream keys(bst.getPreOrderTraversal());
+    T key;
+    while (keys >> key) {
+        tree.add(key);
+    }
+
+    displayTestTitle("TEST DEFERRED CLEAR");
+    tree.setDeferredDestruction(1);
+    tree.clear();
+    cout << "Empty after clear:   " << (tree.empty() ? "True" : "False")
+         << endl;
+    cout << "Pending reclaim:     "
+         << (tree.hasPendingReclaim() ? "True" : "False") << endl;
+    for (int i = 0; i < size / 2; i++) {
+        tree.add(array[i]);
+    }
+    cout << "Tree after adds:     " << tree.getInOrderTraversal() << endl;
+    cout << "reclaim(1):          " << tree.reclaim(1) << endl;
+    cout << "reclaim(100):        " << tree.reclaim(100) << endl;
+    cout << "Pending reclaim:     "
+         << (tree.hasPendingReclaim() ? "True" : "False") << endl;
+
+    // Destroy a deferred copy and a cursor on the background Reclaimer while
+    // the tree still shares their nodes
+    {
+        BST<T> copy(tree);
+        copy.add(array[size - 1]);
+        typename BST<T>::Cursor cursor = copy.getInOrderCursor();
+    }
+    Reclaimer::instance().wait();
+    cout << "Tree after destroy:  " << tree.getInOrderTraversal() << endl;
+}
+
+/**
+ * Tests a CompactBST object against a BSTx object. The compact tree is built
+ * from the data file, has the array removed from it and added back to it
+ * (the same operations the BSTx object went through), and is then copied.
+ * Since a pre-order traversal fixes the shape of a binary search tree, the
+ * copy should have the same pre-order traversal and properties as the BSTx.
+ *
+ * @tparam T       Data type of the trees and array elements (must be
+ *                 primitive)
+ * @param bst      BSTx object
+ * @param dataFile Name of the file the BSTx object was built from
+ * @param array    Array holding data that was removed and added back
+ * @param size     Size of the array
+ */
+template<typename T>
+void testCompact(const BST<T> &bst, const string &dataFile, const T *array,
+                 int size) {
+    CompactBST<T> compact;
+    ifstream inFile(dataFile);
+    T data;
+    while (inFile >> data) {
+        compact.add(data);
+    }
+    for (int i = 0; i < size; i++) {
+        compact.remove(array[i]);
+    }
+    for (int i = 0; i < size; i++) {
+        compact.add(array[i]);
+    }
+    CompactBST<T> copy(compact);
+
+    displayTestTitle("TEST COMPACT");
+    cout << "Pre-order:      " << copy.getPreOrderTraversal() << endl;
+    cout << "In-order:       " << copy.getInOrderTraversal() << endl;
+    cout << "Matches BST:    "
+         << (copy.getPreOrderTraversal() == bst.getPreOrderTraversal() &&
+             copy.size() == bst.size() &&
+             copy.getLeafCount() == bst.getLeafCount() &&
+             copy.getHeight() == bst.getHeight() &&
+             copy.getWidth() == bst.getWidth() ? "True" : "False") << endl;
+}
+
+/**
+ * Tests a StringBST object against a BSTx object of type string, the same way
+ * testCompact does, then against a BST of long keys with shared prefixes and
+ * embedded null characters. The tests are run with prefix skipping both on
+ * and off.
+ *
+ * @param bst      BSTx object
+ * @param dataFile Name of the file the BSTx object was built from
+ * @param array    Array holding data that was removed and added back
+ * @param size     Size of the array
+ */
+void testStringTree(const BST<string> &bst, const string &dataFile,
+                    const string *array, int size) {
+    displayTestTitle("TEST STRING TREE");
+    for (int skip = 1; skip >= 0; skip--) {
+        StringBST strings(skip == 1);
+        ifstream inFile(dataFile);
+        string line;
+        while (getline(inFile, line)) {
+            // Remove carriage return character if found at the end of the line
+            if (line.find('\r') != string::npos) {
+                line.erase(line.find('\r'), 1);
+            }
+            strings.add(line);
+        }
+        for (int i = 0; i < size; i++) {
+            strings.remove(array[i]);
+        }
+        for (int i = 0; i < size; i++) {
+            strings.add(array[i]);
+        }
+        StringBST copy(strings);
+
+        cout << "Prefix skipping " << (skip ? "on" : "off") << ":" << endl;
+        cout << "Pre-order:      " << copy.getPreOrderTraversal() << endl;
+        cout << "In-order:       " << copy.getInOrderTraversal() << endl;
+        cout << "Matches BST:    "
+             << (copy.getPreOrderTraversal() == bst.getPreOrderTraversal() &&
+                 copy.size() == bst.size() &&
+                 copy.getHeight() == bst.getHeight() &&
+                 copy.has(array[0]) && !copy.has(array[0] + "x")
+                 ? "True" : "False") << endl;
+    }
+
+    // The data file's keys are all decided by the cached prefix, so also
+    // check keys longer than it which share long prefixes, and embedded
+    // null characters (which look like the zero padding of a short prefix)
+    const string urls[] = {
+            "https://example.com/docs/api/v1/users/48",
+            "https://example.com/docs/api/v1/users/42",
+            "https://example.com/docs/api/v1/users/45",
+            "https://example.com/docs/api/v1/users",
+            "https://example.com/docs/api/v2/users",
+            "https://example.com/docs/api/v1/user",
+            "https://example.com/docs/",
+            "https://example.com/docs/api/v1/groups",
+            string("https://example.com/docs/api/v1/users") + '\0',
+            string("abc\0def", 7),
+            "abc",
+            string("abc\0", 4),
+            "https://example.com/docs/api/v1/users/7"
+    };
+    const string absent[] = {
+            // Only differs from .../42 and .../45 in the last byte, which
+            // is the first byte that can't be skipped when searching there
+            "https://example.com/docs/api/v1/users/44",
+            "https://example.com/docs/api/v1/use",
+            "https://example.com/docs/api/v1/userz",
+            "https://example.com/docs/api/v3/users",
+            string("abc\0\0", 5),
+            "abcdef"
+    };
+    bool matches = true;
+    for (int skip = 1; skip >= 0; skip--) {
+        StringBST strings(skip == 1);
+        BST<string> expected;
+        for (int i = 0; i < 13; i++) {
+            strings.add(urls[i]);
+            expected.add(urls[i]);
+        }
+        // Remove a node with two children
+        strings.remove(urls[3]);
+        expected.remove(urls[3]);
+        matches = matches &&
+                  strings.getPreOrderTraversal() ==
+                  expected.getPreOrderTraversal() &&
+                  strings.size() == expected.size() && !strings.has(urls[3]);
+        for (int i = 0; i < 13; i++) {
+            matches = matches && (i == 3 || strings.has(urls[i]));
+        }
+        for (int i = 0; i < 6; i++) {
+            matches = matches && !strings.has(absent[i]);
+        }
+    }
+    cout << "Long keys:      " << (matches ? "True" : "False") << endl;
+}
+
+/**
+ * Prints the entries of a BSTMap in order, as key=value pairs.
+ *
+ * @param map   BSTMap object
+ * @param label Label to print before the entries
+ */
+void printMap(const BSTMap<string, int> &map, const string &label) {
+    cout << label;
+    for (BSTMap<string, int>::const_iterator it = map.begin(); it != map.end();
+         ++it) {
+        cout << it.key() << "=" << *it << " ";
+    }
+    cout << endl;
+}
+
+/**
+ * Tests a BSTMap object of type string to int. Each key in the BSTx object is
+ * mapped to its length, the array is then run through operator[],
+ * try_emplace, insert_or_assign, find and erase, and the entries are printed
+ * in order after each step. Last, a fixed map is written and erased through
+ * iterators taken before any of the writes, while a copy shares its nodes.
+ *
+ * @param bst   BSTx object to take the initial keys from
+ * @param array Array holding keys to look up, update and erase
+ * @param size  Size of the array
+ */
+void testMap(const BST<string> &bst, const string *array, int size) {
+    BSTMap<string, int> map;
+    istringstream keys(bst.getPreOrderTraversal());
+    string key;
+    while (keys >> key) {
+        map.insert_or_assign(key, (int) key.length());
+    }
+
+    displayTestTitle("TEST MAP");
+    cout << "Matches BST:    "
+         << (map.getPreOrderTraversal() == bst.getPreOrderTraversal()
+             ? "True" : "False") << endl;
+    printMap(map, "Initial:        ");
+    // Copy shares nodes with the map, and must not see any of its updates
+    const BSTMap<string, int> snapshot(map);
+
+    // Counts go up by one for present keys, absent keys start at 1
+    for (int i = 0; i < size; i++) {
+        map[array[i]]++;
+    }
+    printMap(map, "operator[]++:   ");
+
+    // try_emplace must not overwrite, insert_or_assign must
+    map.try_emplace(array[0], -1);
+    map.insert_or_assign(array[1], 100);
+    printMap(map, "Emplace/assign: ");
+
+    // Update through find, then erase every other entry by iterator
+    BSTMap<string, int>::iterator found = map.find(array[2]);
+    if (found != map.end()) {
+        found.value() *= 10;
+    }
+    for (BSTMap<string, int>::iterator it = map.begin(); it != map.end();) {
+        it = map.erase(it);
+        if (it != map.end()) {
+            ++it;
+        }
+    }
+    printMap(map, "Erase by iter:  ");
+    cout << "Map size:       " << map.size() << endl;
+    printMap(snapshot, "Copy:           ");
+
+    // Iterators taken on a shared map before any write, on both sides of
+    // the same ancestors: each write copies nodes the others hold, and must
+    // still reach the right entry
+    const string shape[] = {"50", "25", "75", "10", "30", "60", "90"};
+    BSTMap<string, int> shared;
+    for (int i = 0; i < 7; i++) {
+        shared.insert_or_assign(shape[i], i);
+    }
+    const BSTMap<string, int> sharedCopy(shared);
+    BSTMap<string, int>::iterator left = shared.find("10");
+    BSTMap<string, int>::iterator right = shared.find("30");
+    BSTMap<string, int>::iterator above = shared.find("25");
+    left.value() = -10;
+    right.value() = -30;
+    shared.erase(above);
+    printMap(shared, "Two iterators:  ");
+    printMap(sharedCopy, "Their copy:     ");
+}
+
+/**
+ * Tests a BSTMultiset object. The keys of the BSTx object are added twice
+ * and the array once, then occurrences are removed one at a time and all at
+ * once, checking count, size, distinct count and rank along the way.
+ *
+ * @tparam T    Data type of the trees and array elements
+ * @param bst   BSTx object to take the initial keys from
+ * @param array Array holding keys to add and remove
+ * @param size  Size of the array
+ */
+template<typename T>
+void testMultiset(const BST<T> &bst, const T *array, int size) {
+    BSTMultiset<T> multiset;
+    for (int round = 0; round < 2; round++) {
+        istringstream keys(bst.getPreOrderTraversal());
+        T key;
+        while (keys >> key) {
+            multiset.add(key);
+        }
+    }
+    for (int i = 0; i < size; i++) {
+        multiset.add(array[i]);
+    }
+
+    displayTestTitle("TEST MULTISET");
+    cout << "# of keys:      " << multiset.size() << endl;
+    cout << "# of distinct:  " << multiset.getDistinctCount() << endl;
+    for (int i = 0; i < size; i++) {
+        cout << "count(" << array[i] << "): " << multiset.count(array[i])
+             << "  rank(" << array[i] << "): " << multiset.rank(array[i])
+             << endl;
+    }
+
+    cout << "Removing one of each: ";
+    for (int i = 0; i < size; i++) {
+        cout << array[i] << " ";
+        multiset.remove(array[i]);
+    }
+    cout << endl;
+    cout << "# of keys:      " << multiset.size() << endl;
+    cout << "# of distinct:  " << multiset.getDistinctCount() << endl;
+    cout << "removeAll(" << array[0] << "): " << multiset.removeAll(array[0])
+         << endl;
+    cout << "has(" << array[0] << "): "
+         << (multiset.has(array[0]) ? "True" : "False") << endl;
+    cout << "In-order:       " << multiset.getInOrderTraversal() << endl;
+}
+
 /**
  * Retrieves name of the file from the user.
  *
@@ -267,6 +724,18 @@ int main() {
         int testInts[] = {20, 40, 10, 70, 99, -2, 59, 43};
         testHas(intBST, testInts, 8);
 
+        // Test lookup cache
+        testCache(intBST, testInts, 8);
+
+        // Test copies share nodes but not changes
+        testCopyOnWrite(intBST, testInts, 8);
+
+        // Test chunked in-order export
+        testCursor(intBST, testInts, 8);
+
+        // Test clearing with deferred destruction
+        testDeferredClear(intBST, testInts, 8);
+
         // Test remove method
         testRemove(intBST, testInts, 8);
         checkBSTProperties(intBST);
@@ -278,6 +747,12 @@ int main() {
         checkBSTProperties(intBST);
         // Test traversal (make sure insertions were successful)
         testTraversal(intBST);
+
+        // Test compact tree (should end up the same as the BST)
+        testCompact(intBST, dataFile, testInts, 8);
+
+        // Test multiset (keys taken from the BST)
+        testMultiset(intBST, testInts, 8);
     }
 
     // Start tests for a BST of strings
@@ -300,6 +775,15 @@ int main() {
                                 "ron", "opal"};
         testHas(stringBST, testStrings, 8);
 
+        // Test lookup cache
+        testCache(stringBST, testStrings, 8);
+
+        // Test copies share nodes but not changes
+        testCopyOnWrite(stringBST, testStrings, 8);
+
+        // Test chunked in-order export
+        testCursor(stringBST, testStrings, 8);
+
         // Test remove method
         testRemove(stringBST, testStrings, 8);
         checkBSTProperties(stringBST);
@@ -311,6 +795,12 @@ int main() {
         checkBSTProperties(stringBST);
         // Test traversal (make sure insertions were successful)
         testTraversal(stringBST);
+
+        // Test string tree (should end up the same as the BST)
+        testStringTree(stringBST, dataFile, testStrings, 8);
+
+        // Test map (keys taken from the BST)
+        testMap(stringBST, testStrings, 8);
     }
 
     outro();